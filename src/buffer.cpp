@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+#include <sys/mman.h>
+
+#include <buffer.hpp>
+
+Buffer::Buffer() {
+	block_ = nullptr;
+	size_ = 0;
+	headroom_ = 0;
+}
+
+Buffer::Buffer(Block *block) {
+	block_ = block;
+	size_ = 0;
+	headroom_ = 0;
+}
+
+Buffer::Buffer(const Buffer &other) {
+	block_ = other.block_;
+	size_ = other.size_;
+	headroom_ = other.headroom_;
+
+	if (block_) {
+		block_->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+Buffer::Buffer(Buffer &&other) {
+	block_ = other.block_;
+	size_ = other.size_;
+	headroom_ = other.headroom_;
+	other.block_ = nullptr;
+	other.size_ = 0;
+	other.headroom_ = 0;
+}
+
+Buffer &Buffer::operator=(Buffer other) {
+	swap(other);
+	return *this;
+}
+
+Buffer::~Buffer() {
+	reset();
+}
+
+unsigned char *Buffer::data() {
+	return block_ ? block_->data + headroom_ : nullptr;
+}
+
+const unsigned char *Buffer::data() const {
+	return block_ ? block_->data + headroom_ : nullptr;
+}
+
+size_t Buffer::size() const {
+	return size_;
+}
+
+size_t Buffer::capacity() const {
+	return block_ ? block_->capacity - headroom_ : 0;
+}
+
+bool Buffer::empty() const {
+	return size_ == 0;
+}
+
+void Buffer::resize(size_t size) {
+	if (size > capacity()) {
+		throw std::logic_error("Buffer resized beyond its capacity.");
+	}
+	size_ = size;
+}
+
+size_t Buffer::headroom() const {
+	return headroom_;
+}
+
+void Buffer::setHeadroom(size_t headroom) {
+	if (!block_ || (headroom + size_ > block_->capacity)) {
+		throw std::logic_error("Buffer headroom beyond its capacity.");
+	}
+	headroom_ = headroom;
+}
+
+bool Buffer::valid() const {
+	return block_ != nullptr;
+}
+
+bool Buffer::unique() const {
+	return block_ && (block_->references.load(std::memory_order_acquire) == 1);
+}
+
+void Buffer::reset() {
+	if (block_) {
+		if (block_->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			block_->pool->release(block_);
+		}
+	}
+	block_ = nullptr;
+	size_ = 0;
+	headroom_ = 0;
+}
+
+void Buffer::swap(Buffer &other) {
+	std::swap(block_, other.block_);
+	std::swap(size_, other.size_);
+	std::swap(headroom_, other.headroom_);
+}
+
+BufferPool::BufferPool(unsigned count, size_t size) {
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+	// round up, so every buffer starts on its own page
+	bufferSize_ = ((size + pageSize - 1) / pageSize) * pageSize;
+	slabSize_ = bufferSize_ * count;
+	locked_ = false;
+
+	void *slab = mmap(nullptr, slabSize_, PROT_READ | PROT_WRITE,
+			  MAP_PRIVATE | MAP_ANON, -1, 0);
+	if (slab == MAP_FAILED) {
+		throw std::bad_alloc();
+	}
+	slab_ = static_cast<unsigned char *>(slab);
+
+	// blocks_ never grows after this, free_ may point into it
+	blocks_ = std::vector<Buffer::Block>(count);
+	free_.reserve(count);
+
+	for (unsigned i = 0; i < count; i++) {
+		Buffer::Block &block = blocks_[i];
+		block.pool = this;
+		block.data = slab_ + i * bufferSize_;
+		block.capacity = size;
+		block.references = 0;
+		free_.push_back(&block);
+	}
+}
+
+BufferPool::~BufferPool() {
+	if (locked_) {
+		munlock(slab_, slabSize_);
+	}
+	munmap(slab_, slabSize_);
+}
+
+Buffer BufferPool::acquire() {
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (free_.empty()) {
+		return Buffer();
+	}
+	Buffer::Block *block = free_.back();
+	free_.pop_back();
+	block->references.store(1, std::memory_order_relaxed);
+	block->owner = shared_from_this();
+
+	return Buffer(block);
+}
+
+int BufferPool::lock() {
+	if (locked_) {
+		return 0;
+	}
+	if (mlock(slab_, slabSize_)) {
+		std::cerr << "Can't lock " << slabSize_ << " bytes of capture buffers in memory: "
+			  << strerror(errno) << std::endl;
+
+		return 1;
+	}
+	locked_ = true;
+
+	return 0;
+}
+
+unsigned BufferPool::getCount() {
+	return blocks_.size();
+}
+
+unsigned BufferPool::getAvailable() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return free_.size();
+}
+
+size_t BufferPool::getBufferSize() {
+	return bufferSize_;
+}
+
+void BufferPool::release(Buffer::Block *block) {
+	// may be the last reference, only let go of it after unlocking
+	std::shared_ptr<BufferPool> owner;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		owner.swap(block->owner);
+		free_.push_back(block);
+	}
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef BUFFER_CLASS_H
+#define BUFFER_CLASS_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class BufferPool;
+
+//Reference counted handle to one capture buffer out of a BufferPool.
+//
+//Copying a handle only bumps the count, so the same captured data can be
+//handed to every output without being copied. The storage goes back to
+//its pool once the last handle is gone. Nothing is ever zero-filled.
+class Buffer {
+		friend class BufferPool;
+	public:
+		Buffer();
+		Buffer(const Buffer &other);
+		Buffer(Buffer &&other);
+		Buffer &operator=(Buffer other);
+		~Buffer();
+
+		unsigned char *data();
+		const unsigned char *data() const;
+		size_t size() const;
+		size_t capacity() const;
+		bool empty() const;
+
+		//Sets size of valid data, must not exceed capacity.
+		void resize(size_t size);
+
+		//Storage kept free in front of data(), IE for a partial packet
+		//to be put in front of what was read in. Capacity counts from
+		//data(). Moving it keeps size, so it can't take more than is
+		//left past the data.
+		size_t headroom() const;
+		void setHeadroom(size_t headroom);
+
+		//Whether this handle refers to any storage at all.
+		bool valid() const;
+
+		//Whether this is the only handle to the storage, IE it is safe
+		//to write into it.
+		bool unique() const;
+
+		void reset();
+		void swap(Buffer &other);
+
+	private:
+		struct Block {
+			BufferPool *pool;
+			std::shared_ptr<BufferPool> owner; //Keeps pool alive while handed out.
+			unsigned char *data;
+			size_t capacity;
+			std::atomic<unsigned> references;
+		};
+
+		Buffer(Block *block);
+
+		Block *block_;
+		size_t size_;
+		size_t headroom_;
+};
+
+//Fixed number of page aligned, equally sized buffers carved out of one
+//slab. Must be owned by a std::shared_ptr: every buffer handed out holds
+//a reference, so the slab stays around until the last one comes back,
+//no matter which thread or output lets go of it last.
+class BufferPool: public std::enable_shared_from_this<BufferPool> {
+		friend class Buffer;
+	public:
+		BufferPool(unsigned count, size_t size);
+		~BufferPool();
+
+		//Returns an invalid handle if every buffer is in use.
+		Buffer acquire();
+
+		//Pins the slab into RAM, so long recordings never page it out.
+		int lock();
+
+		unsigned getCount();
+		unsigned getAvailable();
+		size_t getBufferSize();
+
+	private:
+		void release(Buffer::Block *block);
+
+		unsigned char *slab_;
+		size_t slabSize_;
+		size_t bufferSize_;
+		bool locked_;
+
+		std::vector<Buffer::Block> blocks_;
+		std::vector<Buffer::Block *> free_;
+		std::mutex mutex_;
+};
+
+#endif
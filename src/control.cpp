@@ -0,0 +1,270 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <control.hpp>
+#include <utility.hpp>
+
+#define CONTROL_POLL	250 // How often the threads look at running_, in ms.
+#define CONTROL_LINE	1024 // Longest request line.
+
+int Control::enable(std::string path) {
+	struct sockaddr_un address = {};
+
+	if (path.size() >= sizeof(address.sun_path)) {
+		std::cerr << "Control socket path " << path << " is too long." << std::endl;
+		return 1;
+	}
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+	fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd_ < 0) {
+		std::cerr << "Control socket error: " << strerror(errno) << "." << std::endl;
+		return 1;
+	}
+
+	// left behind by an earlier run
+	unlink(path.c_str());
+
+	if (bind(fd_, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) ||
+	    listen(fd_, 4)) {
+		std::cerr << "Control socket error: " << strerror(errno) << "." << std::endl;
+		close(fd_);
+		fd_ = -1;
+		return 1;
+	}
+	path_ = path;
+
+	running_ = true;
+	thread_ = std::thread(&Control::serve, this);
+	std::cerr << "Control: listening on " << path_ << "." << std::endl;
+	return 0;
+}
+
+void Control::disable() {
+	running_ = false;
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+	if (fd_ != -1) {
+		close(fd_);
+		fd_ = -1;
+		unlink(path_.c_str());
+	}
+}
+
+void Control::serve() {
+	while (running_) {
+		struct pollfd listener = {fd_, POLLIN, 0};
+		if (poll(&listener, 1, CONTROL_POLL) <= 0) {
+			continue;
+		}
+
+		int client = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+		if (client < 0) {
+			continue;
+		}
+		converse(client);
+		close(client);
+	}
+}
+
+void Control::converse(int fd) {
+	std::string pending;
+	char data[CONTROL_LINE];
+
+	while (running_) {
+		struct pollfd client = {fd, POLLIN, 0};
+		int ready = poll(&client, 1, CONTROL_POLL);
+		if (ready == 0) {
+			continue;
+		}
+		if (ready < 0) {
+			return;
+		}
+
+		ssize_t received = recv(fd, data, sizeof(data), 0);
+		if (received <= 0) {
+			return; // hung up
+		}
+		pending.append(data, received);
+
+		size_t end;
+		while ((end = pending.find('\n')) != std::string::npos) {
+			std::string request = pending.substr(0, end);
+			pending.erase(0, end + 1);
+
+			std::string response = handle(Utility::trim(request)) + "\n";
+			if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+				return;
+			}
+		}
+		if (pending.size() > CONTROL_LINE) {
+			return; // not talking our protocol
+		}
+	}
+}
+
+std::string Control::handle(const std::string &request) {
+	std::vector<std::string> words = Utility::split(request, ' ');
+	std::ostringstream response;
+
+	if (words.empty()) {
+		return "error Empty request.";
+	}
+
+	if ((words[0] == "state") && (words.size() == 1)) {
+		response << "ok ";
+		uint16_t state = gchd_->getState();
+		if (state & 0x10) {
+			response << "idle";
+		} else if (state == SCMD_STATE_START) {
+			response << "start";
+		} else if (state == SCMD_STATE_STOP) {
+			response << "stop";
+		} else if (state == SCMD_STATE_NULL) {
+			response << "null";
+		} else {
+			response << "unknown";
+		}
+		if (gchd_->isInputLost()) {
+			response << " input-lost";
+		}
+	} else if ((words[0] == "input") && (words.size() == 1)) {
+		InputSettings input = gchd_->getInputSettings();
+		unsigned horizontal, vertical;
+		input.getResolution(horizontal, vertical);
+
+		response << "ok ";
+		switch (input.getSource()) {
+			case InputSource::HDMI: response << "hdmi"; break;
+			case InputSource::Component: response << "component"; break;
+			case InputSource::Composite: response << "composite"; break;
+			default: response << "unknown"; break;
+		}
+		response << " " << horizontal << "x" << vertical
+			 << " " << (unsigned)std::round(input.getRefreshRate());
+		switch (input.getScanMode()) {
+			case ScanMode::Interlaced: response << " interlaced"; break;
+			case ScanMode::Progressive: response << " progressive"; break;
+			default: response << " unknown"; break;
+		}
+		switch (input.getColorSpace()) {
+			case ColorSpace::RGB: response << " rgb"; break;
+			case ColorSpace::YUV: response << " yuv"; break;
+			default: response << " unknown"; break;
+		}
+	} else if ((words[0] == "output") && (words.size() == 1)) {
+		TranscoderSettings output = gchd_->getTranscoderSettings();
+		unsigned horizontal, vertical;
+		output.getResolution(horizontal, vertical);
+
+		response << "ok " << horizontal << "x" << vertical
+			 << " " << output.getRealMaxBitRateKbps() << " gop ";
+		if (output.getGopSize()) {
+			response << output.getGopSize();
+		} else {
+			response << "auto";
+		}
+	} else if ((words[0] == "stats") && (words.size() == 1)) {
+		response << "ok buffers " << streamer_->getBuffers()
+			 << " bytes " << streamer_->getBytes()
+			 << " overruns " << streamer_->getOverruns()
+			 << " restarts " << gchd_->getRestarts()
+			 << " stripped " << streamer_->getStripped()
+			 << " clients " << streamer_->server.getClients()
+			 << " connections " << streamer_->server.getConnections()
+			 << " served-bytes " << streamer_->server.getBytesSent();
+		if (streamer_->socket.isPacing()) {
+			PacingStats pacing = streamer_->socket.getPacingStats();
+			response << " pacing-error " << static_cast<unsigned>(pacing.meanError)
+				 << " pacing-queue " << pacing.queued;
+		}
+		if (streamer_->dvr.isEnabled()) {
+			response << " dvr-seconds " << static_cast<unsigned>(streamer_->dvr.getSeconds());
+		}
+	} else if ((words[0] == "set") && (words.size() == 3)) {
+		return change(words[1], words[2]);
+	} else if ((words[0] == "clip") && (words.size() == 4)) {
+		char *fromEnd, *toEnd;
+		double from = strtod(words[1].c_str(), &fromEnd);
+		double to = strtod(words[2].c_str(), &toEnd);
+		if (*fromEnd || *toEnd || words[1].empty() || words[2].empty()) {
+			return "error Clip range must be two numbers of seconds ago.";
+		}
+
+		// takes as long as writing the clip out does, capture carries on
+		uint64_t bytes;
+		std::string error;
+		if (!streamer_->dvr.clip(from, to, words[3], bytes, error)) {
+			return "error " + error;
+		}
+		response << "ok " << bytes;
+	} else {
+		return "error Unknown request.";
+	}
+	return response.str();
+}
+
+std::string Control::change(const std::string &setting, const std::string &value) {
+	TranscoderSettings settings = gchd_->getRequestedTranscoderSettings();
+
+	try {
+		if (setting == "bit-rate") {
+			settings.parseBitRate(value);
+		} else if (setting == "gop") {
+			if (value == "auto") {
+				settings.setGopSize(0);
+			} else {
+				char *end;
+				unsigned long frames = strtoul(value.c_str(), &end, 10);
+				if ((*end != 0) || (value[0] == '-')) {
+					return "error GOP size must be a number of frames or `auto`.";
+				}
+				settings.setGopSize(frames);
+			}
+		} else if (setting == "output-resolution") {
+			if (!settings.parseResolution(value)) {
+				return "error Unknown resolution.";
+			}
+		} else {
+			return "error Unknown setting.";
+		}
+
+		if (!gchd_->changeTranscoderSettings(settings, CONTROL_TIMEOUT)) {
+			return "ok pending";
+		}
+	} catch (setting_error &error) {
+		return std::string("error ") + error.what();
+	}
+	return "ok";
+}
+
+Control::Control(GCHD *gchd, Streamer *streamer) {
+	gchd_ = gchd;
+	streamer_ = streamer;
+	fd_ = -1;
+	running_ = false;
+}
+
+Control::~Control() {
+	disable();
+}
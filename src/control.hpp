@@ -0,0 +1,58 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef CONTROL_CLASS_H
+#define CONTROL_CLASS_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <gchd.hpp>
+#include <streamer.hpp>
+
+#define CONTROL_TIMEOUT	5000 // Longest a `set` request waits to be applied, in ms.
+
+//UNIX domain socket for looking at and changing a running capture.
+//
+//One request per line, one response line each, starting with `ok` or
+//`error`:
+//   state                       -> ok <start|stop|null|idle|unknown> [input-lost]
+//   input                       -> ok <source> <x>x<y> <refresh> <scan> <color space>
+//   output                      -> ok <x>x<y> <kbps> gop <frames|auto>
+//   stats                       -> ok buffers <n> bytes <n> overruns <n> restarts <n> stripped <n>
+//                                  clients <n> connections <n> served-bytes <n>
+//                                  [pacing-error <us> pacing-queue <n>] [dvr-seconds <s>]
+//   set bit-rate <mbit-rate>    -> ok, as -bit-rate
+//   set gop <frames>            -> ok, as -gop
+//   set output-resolution <res> -> ok, as -output-resolution
+//   clip <from> <to> <file>     -> ok <bytes>, saves what came in from <from> to <to>
+//                                  seconds ago to <file>, needs -dvr
+//`set` answers `ok pending` if the change couldn't be made yet, IE when
+//nothing is streaming, it is then made once streaming starts.
+class Control {
+	public:
+		int enable(std::string path);
+		void disable();
+		Control(GCHD *gchd, Streamer *streamer);
+		~Control();
+
+	private:
+		void serve(); //Listener thread.
+		void converse(int fd); //One client, until it hangs up.
+		std::string handle(const std::string &request);
+		std::string change(const std::string &setting, const std::string &value);
+
+		GCHD *gchd_;
+		Streamer *streamer_;
+		int fd_;
+		std::string path_;
+		std::thread thread_;
+		std::atomic<bool> running_;
+};
+
+#endif
@@ -5,8 +5,13 @@
  * MIT License. For more information, see LICENSE file.
  */
 
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <disk.hpp>
 
 int Disk::enable(std::string output) {
@@ -19,26 +24,78 @@ int Disk::enable(std::string output) {
 	}
 
 	std::cerr << "Saving to disk: " << output << std::endl;
+	written_ = 0;
+
+	if (indexing_) {
+		// the recording has to reach the disk before the index does,
+		// ofstream won't sync it
+		fd_ = open(output.c_str(), O_WRONLY | O_CLOEXEC);
+		if (fd_ < 0) {
+			std::cerr << "Can't open " << output << ": " << strerror(errno) << std::endl;
+			disk_.close();
+			return 1;
+		}
+		if (index_.open(output + INDEX_SUFFIX)) {
+			disable();
+			return 1;
+		}
+	}
 
 	return 0;
 }
 
 void Disk::disable() {
+	// after the recording, so the index never points past its end
+	if (index_.isOpen() && sync()) {
+		index_.commit();
+	}
+	index_.close();
 	if (disk_.is_open()) {
 		disk_.close();
 	}
+	if (fd_ != -1) {
+		close(fd_);
+		fd_ = -1;
+	}
 }
 
-void Disk::output(std::vector<unsigned char> *buffer) {
+void Disk::output(const Buffer &buffer) {
 	if (!disk_.is_open()) {
 		return;
 	}
 
-	disk_.write(reinterpret_cast<char *>(buffer->data()), static_cast<long>(buffer->size()));
+	disk_.write(reinterpret_cast<const char *>(buffer.data()), static_cast<long>(buffer.size()));
+
+	if (index_.isOpen()) {
+		index_.scan(buffer, written_);
+		if (index_.isDue()) {
+			if (sync()) {
+				index_.commit();
+			} else {
+				index_.postpone();
+			}
+		}
+	}
+	written_ += buffer.size();
+}
+
+bool Disk::sync() {
+	disk_.flush();
+	if (fdatasync(fd_)) {
+		std::cerr << "Can't sync recording: " << strerror(errno) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void Disk::setIndex(bool index) {
+	indexing_ = index;
 }
 
 Disk::Disk() {
 	fd_ = -1;
+	indexing_ = false;
+	written_ = 0;
 }
 
 Disk::~Disk() {
@@ -9,22 +9,33 @@
 #define DISK_CLASS_H
 
 #include <array>
+#include <cstdint>
 #include <fstream>
 #include <string>
 
-#include <gchd.hpp>
+#include <buffer.hpp>
+#include <index.hpp>
 
 class Disk {
 	public:
 		int enable(std::string diskPath);
 		void disable();
-		void output(std::vector<unsigned char> *buffer);
+		void output(const Buffer &buffer);
+		//Write a keyframe index next to the recording, see IndexWriter.
+		void setIndex(bool index);
 		Disk();
 		~Disk();
 
 	private:
-		int fd_;
+		//Flushes the recording and fdatasync()s it, so the index can
+		//point at it.
+		bool sync();
+
+		int fd_; //The recording again, to sync it. -1 without an index.
 		std::ofstream disk_;
+		bool indexing_;
+		IndexWriter index_;
+		uint64_t written_;
 };
 
 #endif
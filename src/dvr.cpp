@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+
+#include <dvr.hpp>
+
+int Dvr::enable(uint64_t size, std::string path) {
+	size_ = size - size % TS_PACKET_SIZE;
+
+	if (path.empty()) {
+		void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED) {
+			std::cerr << "Can't allocate " << size_ << " bytes for the DVR buffer: "
+				  << strerror(errno) << std::endl;
+			return 1;
+		}
+		data_ = static_cast<unsigned char *>(data);
+	} else {
+		// space is taken up front, so the buffer can't run out of disk
+		fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+		int ret = (fd_ < 0) ? errno : posix_fallocate(fd_, 0, size_);
+		void *data = MAP_FAILED;
+		if (!ret) {
+			data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+			ret = (data == MAP_FAILED) ? errno : 0;
+		}
+		if (ret) {
+			std::cerr << "Can't set up " << path << " for the DVR buffer: " << strerror(ret) << std::endl;
+			disable();
+			return 1;
+		}
+		data_ = static_cast<unsigned char *>(data);
+	}
+
+	std::cerr << "DVR: keeping the last " << (size >> 20) << " MiB";
+	if (!path.empty()) {
+		std::cerr << " in " << path;
+	}
+	std::cerr << "." << std::endl;
+	return 0;
+}
+
+void Dvr::disable() {
+	if (data_) {
+		munmap(data_, size_);
+		data_ = nullptr;
+	}
+	if (fd_ != -1) {
+		close(fd_);
+		fd_ = -1;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	keyframes_.clear();
+}
+
+void Dvr::output(const Buffer &buffer) {
+	if (!data_ || !buffer.size()) {
+		return;
+	}
+
+	uint64_t start = written_;
+	std::vector<Keyframe> keyframes;
+	auto now = std::chrono::steady_clock::now();
+
+	for (size_t at = 0; at + TS_PACKET_SIZE <= buffer.size(); at += TS_PACKET_SIZE) {
+		const unsigned char *packet = buffer.data() + at;
+		if (!Ts::isPayloadStart(packet)) {
+			continue;
+		}
+
+		if ((Ts::getPid(packet) == TS_VIDEO_PID) && Ts::isRandomAccess(packet)) {
+			keyframes.push_back(Keyframe{start + at, now});
+		} else if (TsTables::isTable(packet)) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			tables_.update(packet);
+		}
+	}
+
+	// clip() checks writing_ after it has read, so it knows if we got
+	// there first
+	writing_.store(start + buffer.size(), std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	size_t from = start % size_;
+	size_t first = std::min<uint64_t>(buffer.size(), size_ - from);
+	memcpy(data_ + from, buffer.data(), first);
+	memcpy(data_, buffer.data() + first, buffer.size() - first);
+	written_.store(start + buffer.size(), std::memory_order_release);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	keyframes_.insert(keyframes_.end(), keyframes.begin(), keyframes.end());
+	while (!keyframes_.empty() && !isHeld(keyframes_.front().position)) {
+		keyframes_.pop_front();
+	}
+}
+
+bool Dvr::clip(double from, double to, const std::string &path, uint64_t &bytes, std::string &error) {
+	if (!data_) {
+		error = "No DVR buffer, see -dvr.";
+		return false;
+	}
+	if ((from < 0) || (to < 0) || (from <= to)) {
+		error = "Range must go from further back to less far back, in seconds.";
+		return false;
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	auto fromTime = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(from));
+	auto toTime = now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(to));
+
+	uint64_t start, end;
+	std::vector<unsigned char> tables;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (keyframes_.empty()) {
+			error = "No keyframe buffered yet.";
+			return false;
+		}
+
+		// last keyframe at or before from, the oldest one there is if
+		// from is further back than that
+		auto first = std::find_if(keyframes_.begin(), keyframes_.end(),
+					  [&](const Keyframe &keyframe) { return keyframe.time > fromTime; });
+		start = (first == keyframes_.begin()) ? first->position : std::prev(first)->position;
+
+		// up to the first keyframe after to
+		auto last = std::find_if(keyframes_.begin(), keyframes_.end(),
+					 [&](const Keyframe &keyframe) { return keyframe.time > toTime; });
+		end = (last == keyframes_.end()) ? written_.load() : last->position;
+
+		tables_.append(tables);
+	}
+	if (end <= start) {
+		error = "No keyframe in that range.";
+		return false;
+	}
+
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		error = std::string("Can't open ") + path + ": " + strerror(errno) + ".";
+		return false;
+	}
+
+	bool written = (write(fd, tables.data(), tables.size()) == static_cast<ssize_t>(tables.size()));
+	for (uint64_t position = start; written && (position < end);) {
+		size_t at = position % size_;
+		size_t length = std::min<uint64_t>({DVR_CHUNK, end - position, size_ - at});
+		written = (write(fd, data_ + at, length) == static_cast<ssize_t>(length));
+		if (written && !isHeld(position)) {
+			error = "Clip got overwritten while being saved, the DVR buffer is too small for it.";
+			break;
+		}
+		position += length;
+	}
+	if (!written && error.empty()) {
+		error = std::string("Can't write ") + path + ": " + strerror(errno) + ".";
+	}
+
+	if (close(fd) && error.empty()) {
+		error = std::string("Can't write ") + path + ": " + strerror(errno) + ".";
+	}
+	if (!error.empty()) {
+		unlink(path.c_str());
+		return false;
+	}
+	bytes = tables.size() + end - start;
+	std::cerr << "DVR: saved " << bytes << " bytes to " << path << "." << std::endl;
+	return true;
+}
+
+bool Dvr::isEnabled() {
+	return data_ != nullptr;
+}
+
+double Dvr::getSeconds() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (keyframes_.empty()) {
+		return 0.0;
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - keyframes_.front().time).count();
+}
+
+// pairs with the fence in output(): anything read from data_ before this
+// was what it should be if output() hadn't started on it yet
+bool Dvr::isHeld(uint64_t position) {
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return writing_.load(std::memory_order_relaxed) <= position + size_;
+}
+
+Dvr::Dvr() {
+	data_ = nullptr;
+	size_ = 0;
+	fd_ = -1;
+	written_ = 0;
+	writing_ = 0;
+}
+
+Dvr::~Dvr() {
+	disable();
+}
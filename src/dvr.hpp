@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef DVR_CLASS_H
+#define DVR_CLASS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include <buffer.hpp>
+#include <ts.hpp>
+
+#define DVR_CHUNK	(1 << 20) // Bytes written to a clip at a time.
+
+//Time shift buffer: keeps the last so many bytes of the stream, so any
+//part of it can be saved as a clip after the fact, IE for instant
+//replays.
+//
+//output() copies into a fixed size ring, in memory or mapped from a
+//preallocated file, and notes where every keyframe is. clip() writes
+//straight from the ring while output() carries on; output() never waits
+//for it. Should the part being saved get overwritten meanwhile, clip()
+//notices and gives up.
+class Dvr {
+	public:
+		//size is rounded down to whole packets. Empty path keeps it
+		//in memory.
+		int enable(uint64_t size, std::string path);
+		void disable();
+		void output(const Buffer &buffer);
+		//Saves what came in from `from` to `to` seconds ago to path,
+		//as a stream of its own: starting on a keyframe, with the
+		//latest PAT and PMT, and ending before a keyframe. Safe from
+		//any thread.
+		bool clip(double from, double to, const std::string &path, uint64_t &bytes,
+			  std::string &error);
+		bool isEnabled();
+		double getSeconds(); //How far back clips can go. Safe from any thread.
+		Dvr();
+		~Dvr();
+
+	private:
+		struct Keyframe {
+			uint64_t position;
+			std::chrono::steady_clock::time_point time;
+		};
+
+		bool isHeld(uint64_t position); //Not overwritten yet.
+
+		unsigned char *data_;
+		uint64_t size_;
+		int fd_; //Backing file, -1 if in memory.
+
+		//Positions count every byte ever put in, data_ holds the
+		//last size_ of them.
+		std::atomic<uint64_t> written_; //Everything before is in data_,
+		std::atomic<uint64_t> writing_; //and output() may be overwriting up to here.
+
+		std::mutex mutex_;
+		std::deque<Keyframe> keyframes_;
+		TsTables tables_;
+};
+
+#endif
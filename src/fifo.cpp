@@ -5,6 +5,7 @@
  * MIT License. For more information, see LICENSE file.
  */
 
+#include <cerrno>
 #include <csignal>
 #include <iostream>
 
@@ -16,6 +17,13 @@
 #include <fifo.hpp>
 
 int Fifo::enable(std::string output) {
+	if (create(output)) {
+		return 1;
+	}
+	return connect();
+}
+
+int Fifo::create(std::string output) {
 	output_ = output;
 
 	// ignore SIGPIPE, else program terminates on unsuccessful write()
@@ -29,8 +37,12 @@ int Fifo::enable(std::string output) {
 		return 1;
 	}
 
-	std::cerr << "FIFO: " << output << " has been created." << std::endl
-		  << "Waiting for user to open it." << std::endl;
+	std::cerr << "FIFO: " << output << " has been created." << std::endl;
+	return 0;
+}
+
+int Fifo::connect() {
+	std::cerr << "Waiting for user to open " << output_ << "." << std::endl;
 	fd_ = open(output_.c_str(), O_WRONLY);
 
 	if (fd_ < 0) {
@@ -42,6 +54,17 @@ int Fifo::enable(std::string output) {
 	return 0;
 }
 
+void Fifo::disconnect() {
+	if (fd_ >= 0) {
+		close(fd_);
+		fd_ = -1;
+	}
+}
+
+bool Fifo::isConnected() {
+	return fd_ >= 0;
+}
+
 void Fifo::disable() {
 	if (fd_) {
 		close(fd_);
@@ -50,12 +73,15 @@ void Fifo::disable() {
 	}
 }
 
-void Fifo::output(std::vector<unsigned char> *buffer) {
+void Fifo::output(const Buffer &buffer) {
 	if (fd_ == -1) {
 		return;
 	}
 
-	write(fd_, buffer->data(), buffer->size());
+	if ((write(fd_, buffer.data(), buffer.size()) < 0) && (errno == EPIPE)) {
+		std::cerr << "FIFO reader has gone away." << std::endl;
+		disconnect();
+	}
 }
 
 Fifo::Fifo() {
@@ -11,13 +11,18 @@
 #include <array>
 #include <string>
 
-#include <gchd.hpp>
+#include <buffer.hpp>
 
 class Fifo {
 	public:
-		int enable(std::string output);
+		int enable(std::string output); //create(), then connect().
 		void disable();
-		void output(std::vector<unsigned char> *buffer);
+		void output(const Buffer &buffer);
+
+		int create(std::string output);
+		int connect(); //Waits for a reader to open it.
+		void disconnect(); //Closes our end, FIFO stays.
+		bool isConnected(); //False once the reader has gone.
 		Fifo();
 		~Fifo();
 
@@ -5,6 +5,8 @@
  * under the MIT License. For more information, see LICENSE file.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <vector>
 
@@ -12,6 +14,7 @@
 #include <unistd.h>
 
 #include "gchd.hpp"
+#include "gchd/trace.hpp"
 
 // USB VID & PIDs
 #define VENDOR_ELGATO		0x0fd9
@@ -37,18 +40,18 @@ const char * FW_MB86M01_ASSP_NSEC_ENC[] =
 {"MB86M01_ASSP_NSEC_ENC_H",
  "mb86m01_assp_nsec_enc_h.bin" };
 
-// constants
-#define INTERFACE_NUM		0x00
-#define CONFIGURATION_VALUE	0x01
-
 int GCHD::checkDevice() {
 	// initialize device handler
-	if (openDevice()) {
+	if (deviceSettings_.getReplayPath().empty()) {
+		if (openDevice()) {
+			return 1;
+		}
+	} else if (openTrace()) {
 		return 1;
 	}
 
 	// check for firmware files
-	if (checkFirmware()) {
+	if (transport_->needsFirmware() && checkFirmware()) {
 		return 1;
 	}
 	return 0;
@@ -62,25 +65,146 @@ int GCHD::init() {
 	}
 
 	// configure device
-	setupConfiguration();
+	if (deviceSettings_.getResumePath().empty()) {
+		setupConfiguration();
+	} else if (!resumeConfiguration()) {
+		setupConfiguration();
+		saveResumeState();
+	}
+	publishSettings();
 
 	return 0;
 }
 
-void GCHD::stream(std::vector<unsigned char> *buffer, unsigned timeout) {
-	buffer->resize(DATA_BUF); //Make sure full size.
+void GCHD::standby() {
+	uint16_t state = read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER) & 0x1f;
+	if ((state == SCMD_STATE_START) || (state == SCMD_STATE_NULL)) {
+		stopStream(true);
+	}
+	std::cerr << "Device on standby." << std::endl;
+}
+
+void GCHD::resume() {
+	auto start = std::chrono::steady_clock::now();
+
+	//Same transition configureDevice() ends with, stopStream() leaves
+	//the device in SCMD_STATE_STOP as SCMD_INIT does.
+	scmd(SCMD_STATE_CHANGE, 0x00, SCMD_STATE_START);
+	completeStateChange(SCMD_STATE_STOP, SCMD_STATE_START);
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	std::cerr << "Device resumed in "
+		  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+		  << " ms." << std::endl;
+}
 
+void GCHD::stream(Buffer &buffer, unsigned timeout) {
+	buffer.resize(0);
+	buffer.setHeadroom(STREAM_HEADROOM);
 	if (!isInitialized_) {
+		buffer.resize(0);
 		return;
 	}
 
-	int transfer;
+	if (changePending_) {
+		applyTranscoderChange();
+	}
+	if (deviceSettings_.getMonitorInput()) {
+		monitorInput();
+	}
+
+	size_t size = buffer.capacity();
+	if (tuner_) {
+		size = std::min(size, static_cast<size_t>(tuner_->getTransferSize()));
+		timeout = tuner_->getTimeout();
+	}
+
+	IngestRing *ring = ingest();
+	if (ring) {
+		ring->read(buffer, timeout);
+		if (ring->isGone()) {
+			//Unplugged, as in read().
+			process_->setActive(false);
+		}
+	} else {
+		buffer.resize(read(buffer.data(), size, timeout));
+	}
+
+	if (tuner_ && tuner_->record(size, buffer.size())) {
+		if (ingest_) {
+			ingest_->setTransfer(tuner_->getTransferSize(), tuner_->getTimeout());
+		}
+		std::cerr << "USB transfers tuned to " << tuner_->getTransferSize() << " bytes, "
+			  << tuner_->getTimeout() << " ms timeout at "
+			  << static_cast<unsigned>(tuner_->getRate() / 1024) << " KiB/s." << std::endl;
+	}
+}
+
+unsigned GCHD::getQueuedTransfers() {
+	return deviceSettings_.getIngestTransfers();
+}
+
+unsigned GCHD::getRestarts() {
+	return restarts_;
+}
+
+size_t GCHD::getMaximumTransferSize() {
+	return (tuner_ ? MAXIMUM_DATA_BUF : DATA_BUF) + STREAM_HEADROOM;
+}
+
+IngestRing *GCHD::ingest() {
+	unsigned transfers = deviceSettings_.getIngestTransfers();
+	if (!transfers) {
+		return nullptr;
+	}
+
+	if (!ingest_) {
+		if (!transport_->getHandle()) {
+			//Recording and replay only see synchronous transfers.
+			std::cerr << "USB transfers can't be queued here, using synchronous reads." << std::endl;
+			deviceSettings_.setIngestTransfers(0);
+			return nullptr;
+		}
+
+		unsigned size = tuner_ ? tuner_->getTransferSize() : DATA_BUF;
+		unsigned timeout = tuner_ ? tuner_->getTimeout() : TIMEOUT;
+
+		ingest_.reset(new IngestRing(transport_->getHandle(), 0x81, transfers, getMaximumTransferSize(),
+					     size, timeout));
+		ingest_->start();
+		std::cerr << "Queuing " << transfers << " USB transfers for stream." << std::endl;
+	}
+	return ingest_.get();
+}
+
+size_t GCHD::read(unsigned char *data, size_t size, unsigned timeout) {
+	IngestRing *ring = ingest();
+	if (ring) {
+		size_t length = ring->read(data, size, timeout);
+		if (ring->isGone()) {
+			process_->setActive(false);
+		}
+		return length;
+	}
+
+	int transfer = 0;
 
-	libusb_bulk_transfer(devh_, 0x81, buffer->data(), static_cast<int>(buffer->size()), &transfer, timeout);
+	if (transport_->bulkTransfer(0x81, data, static_cast<int>(size), &transfer, timeout) == LIBUSB_ERROR_NO_DEVICE) {
+		//Unplugged, or end of a replayed trace. Either way, we're done.
+		process_->setActive(false);
+	}
 
-	buffer->resize(transfer); //Resize to transferred bytes.
 	//libusb most certainly will partially fill a buffer than timeout
 	//with this operation broken up into multiple transfers.
+	return transfer;
+}
+
+//Reads and throws away stream data, for when device has to be emptied
+//out during state changes.
+void GCHD::drainStream(unsigned count) {
+	for (unsigned i = 0; i < count; i++) {
+		read(drainBuffer_.data(), drainBuffer_.size(), TIMEOUT);
+	}
 }
 
 int GCHD::checkFirmware() {
@@ -143,40 +267,44 @@ int GCHD::openDevice() {
 	// uncomment for verbose debugging
 	//libusb_set_debug(nullptr, LIBUSB_LOG_LEVEL_DEBUG);
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_0);
-	if (devh_) {
+	struct libusb_device_handle *devh;
+
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_0);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHD;
-		return 0;
+		return openTransport(devh);
 	}
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_1);
-	if (devh_) {
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_1);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHD;
-		return 0;
+		return openTransport(devh);
 	}
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_2);
-	if (devh_) {
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_2);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHD;
-		return 0;
+		return openTransport(devh);
 	}
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_3);
-	if (devh_) {
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD_3);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHDNew;
-		return 0;
+		return openTransport(devh);
 	}
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD60);
-	if (devh_) {
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD60);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHD60;
+		transport_.reset(new LibusbTransport(devh));
 		std::cerr << "The Elgato Game Capture HD60 is currently not supported." << std::endl;
 		return 1;
 	}
 
-	devh_ = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD60_S);
-	if (devh_) {
+	devh = libusb_open_device_with_vid_pid(nullptr, VENDOR_ELGATO, GAME_CAPTURE_HD60_S);
+	if (devh) {
 		deviceType_ = DeviceType::GameCaptureHD60S;
+		transport_.reset(new LibusbTransport(devh));
 		std::cerr << "The Elgato Game Capture HD60 S is currently not supported." << std::endl;
 		return 1;
 	}
@@ -189,49 +317,108 @@ int GCHD::openDevice() {
 	return 1;
 }
 
-int GCHD::getInterface() {
-	if (libusb_kernel_driver_active(devh_, INTERFACE_NUM)) {
-		libusb_detach_kernel_driver(devh_, INTERFACE_NUM);
+int GCHD::openTransport(struct libusb_device_handle *devh) {
+	std::unique_ptr<Transport> transport(new LibusbTransport(devh));
+
+	std::string recordPath = deviceSettings_.getRecordPath();
+	if (recordPath.empty()) {
+		transport_ = std::move(transport);
+		return 0;
 	}
 
-	if (libusb_set_configuration(devh_, CONFIGURATION_VALUE)) {
-		if (libusb_set_configuration(devh_, CONFIGURATION_VALUE)) {
-			std::cerr << "Could not set configuration." << std::endl;
-			return 1;
-		}
+	RecordingTransport *recorder = new RecordingTransport(std::move(transport), deviceType_);
+	transport_.reset(recorder);
+	if (recorder->open(recordPath)) {
+		return 1;
 	}
+	std::cerr << "Recording USB traffic to " << recordPath << "." << std::endl;
+	return 0;
+}
+
+int GCHD::openTrace() {
+	std::string replayPath = deviceSettings_.getReplayPath();
 
-	if (libusb_claim_interface(devh_, INTERFACE_NUM)) {
-		std::cerr << "Failed to claim interface." << std::endl;
+	ReplayTransport *replay = new ReplayTransport(deviceSettings_.getReplayTiming());
+	transport_.reset(replay);
+	if (replay->open(replayPath)) {
 		return 1;
 	}
 
+	deviceType_ = replay->getDeviceType();
+	if ((deviceType_ != DeviceType::GameCaptureHD) && (deviceType_ != DeviceType::GameCaptureHDNew)) {
+		std::cerr << "Trace " << replayPath << " is not of a supported device." << std::endl;
+		return 1;
+	}
+	std::cerr << "Replaying USB traffic from " << replayPath << "." << std::endl;
 	return 0;
 }
 
+int GCHD::getInterface() {
+	return transport_->claimInterface();
+}
+
 void GCHD::setupConfiguration() {
 	// set device configuration
 	std::cerr << "Initializing device." << std::endl;
 	isInitialized_ = true;
+
+	//Device may have been touched by someone else since.
+	registerShadow_.invalidate();
+	registerShadow_.resetCounters();
+	parameterBatch_.resetCounters();
+	initStats_.clear();
+	waitStats_.clear();
+
+	auto start = std::chrono::steady_clock::now();
 	configureDevice();
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	std::cerr << "Device initialization took "
+		  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+		  << " ms." << std::endl;
+
+	std::cerr << "Transcoder writes: " << registerShadow_.getWrites() << " sent, "
+		  << parameterBatch_.getMerged() << " merged, "
+		  << registerShadow_.getElided() << " already set." << std::endl;
+
+	if (deviceSettings_.getInitStats()) {
+		printInitStats();
+	}
 }
 
 void GCHD::closeDevice() {
-	if (devh_) {
+	if (transport_) {
 		if (isInitialized_) {
-			uninitDevice();
+			if (deviceSettings_.getResumePath().empty()) {
+				uninitDevice();
+			} else {
+				//Left configured for the next -resume.
+				standby();
+			}
 		}
 
-		libusb_release_interface(devh_, INTERFACE_NUM);
-		libusb_close(devh_);
+		//Transfers must be back from libusb before interface goes.
+		ingest_.reset();
+
+		transport_->releaseInterface();
+		transport_.reset();
 	}
 }
 
 
-GCHD::GCHD(Process *process, InputSettings inputSettings, TranscoderSettings transcoderSettings) {
-	devh_ = nullptr;
+GCHD::GCHD(Process *process, InputSettings inputSettings, TranscoderSettings transcoderSettings,
+	   DeviceSettings deviceSettings) {
 	libusb_ = 1;
 	isInitialized_ = false;
+	batchDepth_ = 0;
+	inputSignal_ = 0.0;
+	inputMode_ = 0.0;
+	inputChanges_ = 0;
+	inputLost_ = false;
+	restarts_ = 0;
+	changesRequested_ = 0;
+	changesApplied_ = 0;
+	changePending_ = false;
+	state_ = 0;
 	deviceType_ = DeviceType::Unknown;
 	process_ = process;
 
@@ -242,6 +429,14 @@ GCHD::GCHD(Process *process, InputSettings inputSettings, TranscoderSettings tra
 	passedTranscoderSettings_ = transcoderSettings;
 	currentTranscoderSettings_ = transcoderSettings;
 
+	deviceSettings_ = deviceSettings;
+
+	if (deviceSettings_.getAdaptiveTransfers()) {
+		tuner_.reset(new TransferTuner(DATA_BUF, MAXIMUM_DATA_BUF, TIMEOUT, MAXIMUM_TIMEOUT));
+	}
+	drainBuffer_.resize(DATA_BUF);
+	registerShadow_.setEnabled(deviceSettings_.getRegisterCache());
+
 	// activate process
 	process->setActive(true);
 }
@@ -9,14 +9,29 @@
 #define GCHD_H
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <string>
 #include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include <libusb-1.0/libusb.h>
 
+#include "buffer.hpp"
+#include "gchd/batch.hpp"
+#include "gchd/detect.hpp"
+#include "gchd/ingest.hpp"
+#include "gchd/init.hpp"
 #include "gchd/settings.hpp"
+#include "gchd/shadow.hpp"
+#include "gchd/transport.hpp"
+#include "gchd/tuner.hpp"
+#include "gchd/wait.hpp"
 #include "process.hpp"
 #include "gchd_hardware.hpp"
 #include "utility.hpp"
@@ -24,6 +39,13 @@
 // constants
 #define DATA_BUF	0x4000 //Has to big enough for HDNew firmware transfers.
 #define TIMEOUT		50 // 50 milliseconds is as long a extra time we want to occur.
+#define MAXIMUM_DATA_BUF	0x10000 // Largest adaptive transfer size.
+#define MAXIMUM_TIMEOUT		250 // Longest adaptive transfer wait, bounds latency.
+#define MAIL_TIMEOUT		1000 // Longest wait for mailbox or enable state handshakes, in ms.
+#define STATE_TIMEOUT		5000 // Longest wait for a state change or firmware start, in ms.
+#define STREAM_HEADROOM		188 // Room in front of each read for a partial TS packet carried over from the last.
+#define MONITOR_INTERVAL	1000 // How often the input is checked while streaming, in ms.
+#define MONITOR_CONFIRM		2 // Checks in a row that must see a change before acting on it.
 
 using std::runtime_error;
 class usb_error: public runtime_error
@@ -38,8 +60,36 @@ class GCHD {
 	public:
 		int checkDevice();
 		int init();
-		void stream(std::vector<unsigned char> *buffer, unsigned timeout=TIMEOUT);
-		GCHD(Process *process, InputSettings inputSettings, TranscoderSettings transcoderSettings);
+		//Stop and restart the encoder, leaving firmware and settings
+		//in place. Used by -daemon between readers.
+		void standby();
+		void resume();
+		//With adaptive transfers enabled, transfer size and timeout
+		//are picked by the tuner instead.
+		void stream(Buffer &buffer, unsigned timeout=TIMEOUT);
+		unsigned getQueuedTransfers(); //Buffers stream() keeps in flight.
+		//Times stream() restarted the encoder on an input change. The
+		//transport stream starts over each time.
+		unsigned getRestarts();
+		size_t getMaximumTransferSize(); //Buffers passed to stream() need this capacity.
+
+		//Safe from any thread, for Control. Settings are as of the
+		//last time the device was configured.
+		InputSettings getInputSettings();
+		TranscoderSettings getTranscoderSettings();
+		TranscoderSettings getRequestedTranscoderSettings(); //Before autodetect, pending changes included.
+		uint16_t getState(); //Last confirmed SCMD_STATE_*, 0 if none yet.
+		bool isInputLost();
+
+		//Hands settings to the thread calling stream(), which applies
+		//them between two reads, holding the encoder in
+		//SCMD_STATE_NULL meanwhile. Waits up to timeout ms, returns
+		//false if they weren't applied by then, they still will be.
+		//Throws setting_error if they don't work with the input.
+		bool changeTranscoderSettings(TranscoderSettings settings, unsigned timeout);
+
+		GCHD(Process *process, InputSettings inputSettings, TranscoderSettings transcoderSettings,
+		     DeviceSettings deviceSettings);
 		~GCHD();
 
 	private:
@@ -47,20 +97,63 @@ class GCHD {
 		bool isInitialized_;
 		std::string firmwareIdle_;
 		std::string firmwareEnc_;
-		struct libusb_device_handle *devh_;
+		std::unique_ptr<Transport> transport_; //All device access goes through here.
+		std::unique_ptr<IngestRing> ingest_; //Only used if transfers are queued.
+		std::unique_ptr<TransferTuner> tuner_; //Only used for adaptive transfers.
+		std::vector<unsigned char> drainBuffer_; //Stream data we throw away.
+		RegisterShadow registerShadow_; //Transcoder words as last written.
+		ParameterBatch parameterBatch_; //sparam writes not sent yet.
+		unsigned batchDepth_; //sparam writes are held back while > 0.
+		std::map<std::string, InitStats> initStats_; //By sequence name.
+		std::map<std::string, WaitStats> waitStats_; //By what was waited for.
+
+		//Input monitoring, see monitorInput().
+		double inputSignal_; //0x6665 as detected at configuration.
+		double inputMode_; //Mode register as detected at configuration.
+		unsigned inputChanges_; //Checks in a row that saw a different input.
+		std::atomic<bool> inputLost_; //Reconfiguration failed, encoder is stopped.
+		std::atomic<unsigned> restarts_;
+		std::chrono::steady_clock::time_point nextMonitor_;
+
+		//What other threads get to see, see getInputSettings() and
+		//changeTranscoderSettings(). All under controlMutex_.
+		std::mutex controlMutex_;
+		std::condition_variable changeApplied_;
+		InputSettings publishedInput_;
+		TranscoderSettings publishedTranscoder_;
+		TranscoderSettings publishedRequest_;
+		TranscoderSettings pendingTranscoder_;
+		unsigned long changesRequested_;
+		unsigned long changesApplied_;
+		std::string changeError_;
+		std::atomic<bool> changePending_;
+		std::atomic<uint16_t> state_;
+
+		IngestRing *ingest(); //nullptr when using synchronous reads.
+		size_t read(unsigned char *data, size_t size, unsigned timeout);
+		void drainStream(unsigned count);
 
 		uint16_t savedEnableRegister_;
 		uint16_t savedEnableStateRegister_;
 
 		int checkFirmware();
 		int openDevice(); //At USB level
+		int openTransport(struct libusb_device_handle *devh);
+		int openTrace(); //Replay instead of USB device
 		void closeDevice(); //At USB level
 		int getInterface();
 		void setupConfiguration();
+		bool resumeConfiguration(); //False if device needs initialization.
+		void saveResumeState();
 		void configureDevice(); //At Device level
 		void uninitDevice();    //At Device level
 		void configureHDMI();
 		void configureComponent();
+		void publishSettings(); //After every configuration.
+		void applyTranscoderChange(); //Called while streaming, see changeTranscoderSettings().
+		void monitorInput(); //Called while streaming, reconfigures if input changed.
+		bool inputChanged();
+		void reconfigureInput();
 		void configureComposite();
 		void configureColorSpace();
 
@@ -70,11 +163,47 @@ class GCHD {
 		void configureCommonBlockB2();
 		void configureCommonBlockB3();
 		void configureCommonBlockC();
-		void readHdmiSignalInformation(unsigned &sum6463, unsigned &countSum6464,
-					       unsigned &sum6665, unsigned &countSum6665,
+		void readHdmiSignalInformation(unsigned &value6463, unsigned &value6665,
 					       bool &colorBit);
-		void readComponentSignalInformation(unsigned &sum6867, unsigned &countSum6867,
-						    unsigned &sum6665, unsigned &countSum6665);
+		void readComponentSignalInformation(unsigned &value6867, unsigned &value6665);
+
+		//Reads the input until it settles, see SignalDetector. read
+		//fills in 0x6665 and the mode register. Returns the time
+		//taken, for recordDetection() once the mode is known.
+		template<typename F>
+		WaitStats detectSignal(const char *source, SignalDetector &detector, F read) {
+			WaitStats detection = {};
+			{
+				WaitTimer timer(detection, SIGNAL_TIMEOUT);
+				unsigned signal, mode;
+				read(signal, mode);
+				while (!detector.add(signal, mode)) {
+					if (!timer.backoff()) {
+						if (!detector.hasSignal()) {
+							throw runtime_error( std::string("No ") + source + " signal found." );
+						}
+						throw runtime_error( std::string(source) + " signal did not settle." );
+					}
+					read(signal, mode);
+				}
+			}
+			return detection;
+		}
+		void recordDetection(const char *source, const WaitStats &detection);
+
+		//Runs a table from init_sequences.hpp.
+		void runInit(const char *name, const InitOp *ops, size_t count);
+		template<size_t N>
+		void runInit(const char *name, const InitOp (&ops)[N]) {
+			runInit(name, ops, N);
+		}
+		void printInitStats();
+
+		//Every control transfer but sparam's goes through here, so
+		//batched sparam writes always reach the device before anything
+		//that could depend on them.
+		int controlTransfer(uint8_t requestType, uint8_t bRequest, uint16_t wValue, uint16_t wIndex,
+				    unsigned char *data, uint16_t wLength);
 
 		void read_config_buffer(uint8_t bRequest, uint16_t wValue, uint16_t wIndex, unsigned char *buffer, uint16_t wLength);
 
@@ -100,7 +229,7 @@ class GCHD {
 			std::vector<unsigned char> recv=std::vector<unsigned char>(wLength);
 
 			int returnSize=
-					libusb_control_transfer(devh_, 0xc0, bRequest, wValue, wIndex, recv.data(), recv.size(), 0);
+					controlTransfer(0xc0, bRequest, wValue, wIndex, recv.data(), recv.size());
 
 			if  (returnSize != wLength)
 			{
@@ -141,7 +270,7 @@ class GCHD {
 			Utility::byteify<T>( send.data(), value, wLength );
 
 			int returnSize=
-					libusb_control_transfer(devh_, 0x40, bRequest, wValue, wIndex, send.data(), wLength, 0);
+					controlTransfer(0x40, bRequest, wValue, wIndex, send.data(), wLength);
 
 			if  (returnSize != wLength)
 			{
@@ -149,6 +278,18 @@ class GCHD {
 			}
 		}
 
+		//Calls done() until it returns true, backing off between
+		//calls. Throws usb_error after timeout milliseconds.
+		template<typename F>
+		void waitFor(const char *name, unsigned timeout, F done) {
+			WaitTimer timer(waitStats_[name], timeout);
+			while (!done()) {
+				if (!timer.backoff()) {
+					throw usb_error( std::string("Timed out waiting for ") + name + "." );
+				}
+			}
+		}
+
 		void interruptPend();
 		void sendEnableState(); //saves and sends enable state to other device/processor.
 		//Write savedEnableStateRegister_ to SEND_ENABLE_REGISTER_STATE
@@ -176,7 +317,28 @@ class GCHD {
 		void sparam(uint16_t address, uint8_t lsb, uint8_t bits, uint16_t data);
 		void sparam(const bitfield_t &bitField, uint16_t data);
 
+		//Between these, sparam writes to the same word are merged and
+		//sent as one. Calls nest, the outermost end sends everything.
+		void beginParameters();
+		void endParameters();
+		void flushParameters(); //Sends batched writes now.
+		void sendParameter(uint16_t address, uint32_t value, uint32_t mask);
+
+		//Batches sparam writes until end(), which sends them. Left
+		//without end(), IE by an exception, the batch is thrown away:
+		//sending may throw, which a destructor must not.
+		class ParameterScope {
+			public:
+				ParameterScope(GCHD *gchd);
+				~ParameterScope();
+				void end();
+			private:
+				GCHD *gchd_;
+				bool ended_;
+		};
+
 		void slsi(uint16_t wIndex, uint16_t data);
+		void selectBank(uint16_t bank); //Writes BANKSEL.
 		void transcoderTableWrite(uint16_t address, std::vector<uint8_t> &data);
 
 		void mailReadyWait();
@@ -214,6 +376,8 @@ class GCHD {
 		TranscoderSettings passedTranscoderSettings_;
 		TranscoderSettings currentTranscoderSettings_;
 
+		DeviceSettings deviceSettings_;
+
 		uint16_t specialDetectMask_;
 
 
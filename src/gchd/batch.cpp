@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include "batch.hpp"
+
+ParameterBatch::ParameterBatch() {
+	merged_ = 0;
+}
+
+void ParameterBatch::add(uint16_t address, uint32_t value, uint32_t mask) {
+	auto it = index_.find(address);
+	if (it == index_.end()) {
+		index_[address] = words_.size();
+		words_.push_back(Word{address, value & mask, mask});
+		return;
+	}
+
+	Word &word = words_[it->second];
+	word.value = (word.value & ~mask) | (value & mask);
+	word.mask |= mask;
+	merged_++;
+}
+
+bool ParameterBatch::empty() {
+	return words_.empty();
+}
+
+std::vector<ParameterBatch::Word> ParameterBatch::take() {
+	std::vector<Word> words;
+	words.swap(words_);
+	index_.clear();
+	return words;
+}
+
+unsigned long ParameterBatch::getMerged() {
+	return merged_;
+}
+
+void ParameterBatch::resetCounters() {
+	merged_ = 0;
+}
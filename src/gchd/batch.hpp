@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+//Transcoder bitfield writes waiting to go out. Writes to the same 32 bit
+//word are merged into one value/mask pair, later bits winning, and words
+//go out in the order they were first written to.
+class ParameterBatch {
+	public:
+		struct Word {
+			uint16_t address;
+			uint32_t value;
+			uint32_t mask;
+		};
+
+		ParameterBatch();
+
+		void add(uint16_t address, uint32_t value, uint32_t mask);
+		bool empty();
+
+		//Hands over everything pending, leaving the batch empty.
+		std::vector<Word> take();
+
+		unsigned long getMerged(); //Writes that didn't need a word of their own.
+		void resetCounters();
+
+	private:
+		std::vector<Word> words_;
+		std::unordered_map<uint16_t, size_t> index_; //Address to words_ position.
+		unsigned long merged_;
+};
+
+#endif
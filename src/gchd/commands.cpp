@@ -13,10 +13,16 @@
 #include "../gchd.hpp"
 #include "../gchd_hardware.hpp"
 
+int GCHD::controlTransfer(uint8_t requestType, uint8_t bRequest, uint16_t wValue, uint16_t wIndex,
+			  unsigned char *data, uint16_t wLength) {
+	flushParameters();
+	return transport_->controlTransfer(requestType, bRequest, wValue, wIndex, data, wLength, 0);
+}
+
 void GCHD::read_config_buffer( uint8_t bRequest, uint16_t wValue, uint16_t wIndex, unsigned char *buffer, uint16_t readSize) {
 	uint16_t wLength=readSize;
 	int returnSize=
-			libusb_control_transfer(devh_, 0xc0, bRequest, wValue, wIndex, buffer, wLength, 0);
+			controlTransfer(0xc0, bRequest, wValue, wIndex, buffer, wLength);
 
 	if (returnSize != wLength)
 	{
@@ -29,7 +35,7 @@ void GCHD::read_config(uint8_t bRequest, uint16_t wValue, uint16_t wIndex, uint1
 	std::vector<unsigned char> recv(wLength);
 
 	int returnSize=
-			libusb_control_transfer(devh_, 0xc0, bRequest, wValue, wIndex, recv.data(), static_cast<uint16_t>(recv.size()), 0);
+			controlTransfer(0xc0, bRequest, wValue, wIndex, recv.data(), static_cast<uint16_t>(recv.size()));
 
 	if (returnSize != wLength)
 	{
@@ -40,7 +46,7 @@ void GCHD::read_config(uint8_t bRequest, uint16_t wValue, uint16_t wIndex, uint1
 void GCHD::write_config_buffer( uint8_t bRequest, uint16_t wValue, uint16_t wIndex, unsigned char *buffer, uint16_t wLength) {
 
 	int returnSize=
-			libusb_control_transfer(devh_, 0x40, bRequest, wValue, wIndex, buffer, wLength, 0);
+			controlTransfer(0x40, bRequest, wValue, wIndex, buffer, wLength);
 
 	if (returnSize != wLength)
 	{
@@ -51,9 +57,15 @@ void GCHD::write_config_buffer( uint8_t bRequest, uint16_t wValue, uint16_t wInd
 void GCHD::interruptPend()
 {
 	unsigned char input[3];
-	int returnSize;
+	int returnSize = 0;
+	flushParameters();
+	WaitTimer timer(waitStats_["interrupt"], STATE_TIMEOUT);
 	int status=
-			libusb_interrupt_transfer(devh_, 0x83, input, 3, &returnSize, 0);
+			transport_->interruptTransfer(0x83, input, 3, &returnSize, STATE_TIMEOUT);
+	if( status == LIBUSB_ERROR_TIMEOUT )
+	{
+		throw usb_error("Timed out pending on USB interrupt.\n");
+	}
 	if( status != 0 )
 	{
 		throw usb_error("USB error when pending on USB interrupt.\n");
@@ -62,15 +74,15 @@ void GCHD::interruptPend()
 
 void GCHD::sendEnableState()
 {
-	uint16_t status;
-	do {
+	waitFor("enable state", MAIL_TIMEOUT, [&]() {
 		write_config<uint16_t>( MAIL_SEND_ENABLE_REGISTER_STATE, savedEnableStateRegister_ );
-		status = read_config<uint16_t>(MAIL_REQUEST_READY);
+		uint16_t status = read_config<uint16_t>(MAIL_REQUEST_READY);
 
 		uint16_t detectMask = (status >> 8) & 3; //Cable type.
 		detectMask |= (((status >> 10) & 3) != 0) <<3; //Is either cable presence bit set.
 		specialDetectMask_ &= detectMask;
-	} while ( (status & 1) == 0);
+		return (status & 1) != 0;
+	});
 }
 
 /* Doesn't return value to emphasize that something in object is being changed */
@@ -164,6 +176,12 @@ void GCHD::clearEnableStateBits( uint16_t clearMask ) {
  *   stream during the encoding process.
  */
 void GCHD::scmd(uint8_t command, uint8_t mode, uint16_t data) {
+	//Resets and firmware loads (SCMD_INIT mode 0) leave transcoder
+	//parameters in whatever state the firmware puts them.
+	if(( command == SCMD_RESET ) || (( command == SCMD_INIT ) && ( mode == 0x00 ))) {
+		registerShadow_.invalidate();
+	}
+
 	uint8_t send[6] = {0};
 	send[2] = command;
 	send[3] = mode;
@@ -185,11 +203,10 @@ void GCHD::scmd(uint8_t command, uint8_t mode, uint16_t data) {
 				//least for SCMD_INITs after 1st.
 			{
 				interruptPend();
-				uint16_t value;
-				do
-				{
-					value=read_config<uint16_t>(HDNEW_SCMD_READBACK_REGISTER);
-				} while ((value >> 8) != command); //TODO! Probably should set timeout
+				waitFor("scmd", STATE_TIMEOUT, [&]() {
+					uint16_t value=read_config<uint16_t>(HDNEW_SCMD_READBACK_REGISTER);
+					return (value >> 8) == command;
+				});
 			}
 		}
 	}
@@ -201,43 +218,54 @@ uint16_t GCHD::completeStateChange( uint16_t currentState,
 {
 	bool firstTime=true;
 	uint16_t state;
-	bool changed=false;
 	do
 	{
-		do
-		{
+		bool unexpected=false;
+		//Not waitFor(), draining the stream would eat into the timeout.
+		WaitTimer timer(waitStats_["state change"], STATE_TIMEOUT);
+		auto done = [&]() {
 			state=read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER);
 
 			state &= 0x1f; //Masking off bits we don't ever see.
 			if((state != currentState) && (state != nextState))
 			{
-				//Successful reset can clear state.
-				if( firstTime ) {
-					return state;
-				} else {
-					throw std::runtime_error( "Device transitioned to unexpected state.");
-				}
+				unexpected=true;
+				return true;
 			}
 			firstTime=false;
 
 			//forceStreamEmpty is a terrible hack that needs to die.
 			if( forceStreamEmpty )
 			{
-				std::vector<unsigned char> buffer=std::vector<unsigned char>(DATA_BUF);
 				//Streaming happens at top of loop, and after each 0x01b0 command, this seems
 				//proper place to put it.
-				for (int i = 0; i < 50; i++)
-				{
-					stream(&buffer);
-				}
+				auto start = std::chrono::steady_clock::now();
+				drainStream(50);
+				timer.exclude(std::chrono::steady_clock::now() - start);
 			}
 
 			uint16_t completion=read_config<uint16_t>(SCMD_STATE_CHANGE_COMPLETE);
-			changed = (completion & 0x4)>0; //Check appropriate bit
+			bool changed = (completion & 0x4)>0; //Check appropriate bit
 
 
 			read_config<uint16_t>(0xbc, 0x0900, 0x01b0); //Not sure what to do with this if anything
-		} while(not changed);
+			return changed;
+		};
+		while (!done()) {
+			if (!timer.backoff()) {
+				throw usb_error("Timed out waiting for state change.");
+			}
+		}
+		if( unexpected )
+		{
+			//Successful reset can clear state.
+			if( firstTime ) {
+				state_ = state;
+				return state;
+			} else {
+				throw std::runtime_error( "Device transitioned to unexpected state.");
+			}
+		}
 
 		//Double read here for unknown purposes.
 		state=read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER);
@@ -249,6 +277,7 @@ uint16_t GCHD::completeStateChange( uint16_t currentState,
 		write_config<uint16_t>(0xbc, 0x0900, 0x01b0, 0x0000);
 	} while ( state != nextState );
 
+	state_ = state;
 	return state;
 }
 
@@ -341,20 +370,83 @@ void GCHD::sparam(uint16_t address, uint8_t lsb, uint8_t bits, uint16_t data) {
 	outputMask<<=shift;
 
 
+	if( batchDepth_ > 0 ) {
+		parameterBatch_.add( outputAddress, outputData, outputMask );
+		return;
+	}
+
+	//Already there from an earlier write, nothing to do.
+	if( registerShadow_.elide( outputAddress, outputData, outputMask ) ) {
+		return;
+	}
+	sendParameter( outputAddress, outputData, outputMask );
+}
+
+void GCHD::sendParameter(uint16_t address, uint32_t value, uint32_t mask) {
 	//Prepare 8 byte send buffer....
 	unsigned char send[8];
 	//Do big endian conversions of 32 bit into there.
-	Utility::byteify<uint32_t>( send, outputData );
-	Utility::byteify<uint32_t>( send+4, outputMask );
+	Utility::byteify<uint32_t>( send, value & mask );
+	Utility::byteify<uint32_t>( send+4, mask );
 
 
 	int returnSize =
-			libusb_control_transfer(devh_, 0x40, SEND_H264_TRANSCODER_BITFIELD, outputAddress, send, 8, 0);
+			transport_->controlTransfer(0x40, SEND_H264_TRANSCODER_BITFIELD, address, send, 8, 0);
 
 	if(returnSize < 8 )
 	{
+		registerShadow_.invalidate( address );
 		throw usb_error("USB error when sending sparam.\n");
 	}
+	registerShadow_.update( address, value, mask );
+}
+
+void GCHD::beginParameters() {
+	batchDepth_++;
+}
+
+void GCHD::endParameters() {
+	if( batchDepth_ > 0 ) {
+		batchDepth_--;
+	}
+	if( batchDepth_ == 0 ) {
+		flushParameters();
+	}
+}
+
+//One transfer per word, only carrying the bits that actually change.
+//Firmware only acts on these once told to by scmd or similar, which
+//flushes first, so order between words doesn't matter in between.
+void GCHD::flushParameters() {
+	if( parameterBatch_.empty() ) {
+		return;
+	}
+	for( auto &word : parameterBatch_.take() ) {
+		if( registerShadow_.elide( word.address, word.value, word.mask ) ) {
+			continue;
+		}
+		uint32_t mask=registerShadow_.changed( word.address, word.value, word.mask );
+		sendParameter( word.address, word.value, mask );
+	}
+}
+
+GCHD::ParameterScope::ParameterScope(GCHD *gchd) {
+	gchd_ = gchd;
+	ended_ = false;
+	gchd_->beginParameters();
+}
+
+GCHD::ParameterScope::~ParameterScope() {
+	if( !ended_ ) {
+		//Configuration failed halfway, device state is unknown anyway.
+		gchd_->batchDepth_ = 0;
+		gchd_->parameterBatch_.take();
+	}
+}
+
+void GCHD::ParameterScope::end() {
+	ended_ = true;
+	gchd_->endParameters();
 }
 
 //Polymorphic one that takes struct
@@ -374,18 +466,39 @@ void GCHD::sparam(const bitfield_t &bitfield, uint16_t data) {
  *  vertical size and bitrate.
  */
 void GCHD::slsi(uint16_t address, uint16_t data) {
+	//Same words as sparam, a whole 16 bit half of one.
+	uint16_t wordAddress = address & ~3;
+	unsigned shift = ((address & 2) == 0) ? 16 : 0;
+	uint32_t wordData = (uint32_t)data << shift;
+	uint32_t wordMask = (uint32_t)0xffff << shift;
+
+	//Table writes may overlap batched words, those go first.
+	flushParameters();
+	if( registerShadow_.elide( wordAddress, wordData, wordMask ) ) {
+		return;
+	}
+
 	uint8_t send[2] = {0};
 
 	// splitting up data to two 8-bit integers by bitshifting and masking
 	Utility::byteify<uint16_t>(send, data);
 
 	int returnSize =
-			libusb_control_transfer(devh_, 0x40, SEND_H264_TRANSCODER_WORD, address, send, 2, 0);
+			transport_->controlTransfer(0x40, SEND_H264_TRANSCODER_WORD, address, send, 2, 0);
 
 	if(returnSize != 2 )
 	{
+		registerShadow_.invalidate( wordAddress );
 		throw usb_error("USB error in SLSI.\n");
 	}
+	registerShadow_.update( wordAddress, wordData, wordMask );
+}
+
+//Register is named BANKSEL from script files. Transcoder words we know of
+//only hold for the bank selected when they were written.
+void GCHD::selectBank(uint16_t bank) {
+	write_config<uint16_t>(BANKSEL, bank);
+	registerShadow_.selectBank( bank );
 }
 
 //
@@ -414,14 +527,14 @@ void GCHD::transcoderTableWrite(uint16_t address, std::vector<uint8_t> &data)
 
 void GCHD::mailReadyWait()
 {
-	uint16_t status;
-	do {
-		status=read_config<uint16_t>(MAIL_REQUEST_READY);
+	waitFor("mail ready", MAIL_TIMEOUT, [&]() {
+		uint16_t status=read_config<uint16_t>(MAIL_REQUEST_READY);
 
 		uint16_t detectMask = (status >> 8) & 3; //Cable type.
 		detectMask |= (((status >> 10) & 3) != 0) <<3; //Is either cable presence bit set.
 		specialDetectMask_ &= detectMask;
-	} while( (status & 1) == 0 );
+		return (status & 1) != 0;
+	});
 }
 
 void GCHD::mailWrite( uint8_t port, const std::vector<unsigned char> &writeVector )
@@ -520,7 +633,13 @@ std::vector<unsigned char> GCHD::mailRead( uint8_t port,
  * @param file path to binary firmware file
  */
 void GCHD::dlfirm(const char *file) {
-	int transfer;
+	int transfer = 0;
+
+	flushParameters();
+	registerShadow_.invalidate();
+	if (!transport_->needsFirmware()) {
+		return;
+	}
 
 	FILE *bin;
 	bin = fopen(file, "rb");
@@ -546,7 +665,7 @@ void GCHD::dlfirm(const char *file) {
 		}
 
 		fread(buffer.data(), static_cast<unsigned long>(bytes_remain), 1, bin);
-		libusb_bulk_transfer(devh_, EP_OUT, buffer.data(), static_cast<int>(bytes_remain), &transfer, 0);
+		transport_->bulkTransfer(EP_OUT, buffer.data(), static_cast<int>(bytes_remain), &transfer, 0);
 	}
 	fclose(bin);
 }
@@ -563,13 +682,12 @@ uint8_t GCHD::readDevice0x9DCD( uint8_t index )
 //Reads from unknown device. Done so often, made it a subroutine
 void GCHD::pollOn0x9989ED()
 {
-	uint8_t input;
-	do
-	{
+	waitFor("0x9989ED", MAIL_TIMEOUT, [&]() {
 		mailWrite( 0x33, VC{ 0x99, 0x89, 0xed } );
-		input=mailRead( 0x33, 1 )[0];
+		uint8_t input=mailRead( 0x33, 1 )[0];
 		//bit 6 will be set when polling done.
-	} while( (input & 0x40 ) == 0 );
+		return (input & 0x40 ) != 0;
+	});
 }
 
 void GCHD::readFrom0x9989EC( unsigned count )
@@ -596,29 +714,21 @@ void GCHD::stopStream( bool emptyBuffer )
 	 * I'm working with. Receive empty data, after setting state change to
 	 * null transfer.
 	 */
-	std::vector<unsigned char> buffer=std::vector<unsigned char>(DATA_BUF);
-
 	if( emptyBuffer )
 	{
-		for (int i = 0; i < 200; i++) {
-			stream(&buffer);
-		}
+		drainStream(200);
 	}
 	completeStateChange(  SCMD_STATE_START, SCMD_STATE_NULL, emptyBuffer );
 	if( emptyBuffer )
 	{
-		for (int i = 0; i < 20; i++) {
-			stream(&buffer);
-		}
+		drainStream(20);
 	}
 	// state change - stop encoding
 	scmd(SCMD_STATE_CHANGE, 0x00, SCMD_STATE_STOP);
 	completeStateChange(  SCMD_STATE_NULL, SCMD_STATE_STOP, emptyBuffer );
 	if( emptyBuffer )
 	{
-		for( int i=0; i < 5 ; i++ ) {
-			stream(&buffer);
-		}
+		drainStream(5);
 	}
 }
 
@@ -639,13 +749,11 @@ void GCHD::clearEnableState()
 
 	//And we grab it again after turning it off.
 	//This time we poll on it till it is ready, just in case.
-	uint32_t result;
-	do
-	{
+	waitFor("processor stop", STATE_TIMEOUT, [&]() {
 		mailWrite( 0x33, VC{0xab, 0xa9, 0x0f, 0xa4, 0x55} );
 		read=mailRead( 0x33, 3 ); //EXPECTED {0x33, 0x44, 0x55};
-		result=Utility::debyteify<uint32_t>(read.data(),3);
-	} while(result != 0x334455);
+		return Utility::debyteify<uint32_t>(read.data(),3) == 0x334455;
+	});
 }
 
 //Read firmware version information.
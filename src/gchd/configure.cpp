@@ -9,6 +9,7 @@
 #include <cmath>
 #include <iostream>
 #include "../gchd.hpp"
+#include "init_sequences.hpp"
 
 
 //This runs the commands for all configurations up until a point they diverge
@@ -20,7 +21,7 @@ void GCHD::configureDevice()
 	std::cerr << "Hardware revision is " << version.data() << std::endl;
 
 	//register is named BANKSEL from script files.
-	write_config<uint16_t>(BANKSEL, 0x0000);
+	selectBank(0x0000);
 
 	//Get what is enabled in case we aren't in boot state, we may need to disable
 	savedEnableStateRegister_ = read_config<uint16_t>(MAIL_SEND_ENABLE_REGISTER_STATE);
@@ -46,18 +47,16 @@ void GCHD::configureDevice()
 		//We can't use completeStateChange for HDNew,
 		//as the read triggers an interrupt, which
 		//the normal completeStateChange code doesn't handle.
-		bool changed;
 		state=read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER);
 		state &= 0x1f; //Ignore any other bits other than the ones we care about.
 
 		if( state == 0x0000 )
 		{
 			interruptPend();
-			do
-			{
+			waitFor("state change", STATE_TIMEOUT, [&]() {
 				uint16_t completion=read_config<uint16_t>(SCMD_STATE_CHANGE_COMPLETE);
-				changed = (completion & 0x4)>0; //Check appropriate bit
-			} while (!changed);
+				return (completion & 0x4)>0; //Check appropriate bit
+			});
 
 			//Reset sticky bit/acknowledge.
 			write_config<uint16_t>(SCMD_STATE_CHANGE_COMPLETE, 0x0004);
@@ -267,23 +266,7 @@ void GCHD::configureDevice()
 	} while(input[0] != 0xf7);
 	doEnable( EB_ENCODER_TRIGGER, 0 ); //Turn off trigger bit
 
-	mailWrite( 0x33, VC{0x89, 0x89, 0xfb} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6e}
-
-	//Potential subroutine
-	{
-		mailWrite( 0x44, VC{0x02, 0xc9} );
-		mailWrite( 0x44, VC{0x14, 0xd2} );
-		mailWrite( 0x44, VC{0x3c, 0x6b} );
-		mailWrite( 0x33, VC{0x89, 0x89, 0xfa} );
-		mailRead( 0x33, 1 ); //EXPECTED {0xed}
-	}
-	mailWrite( 0x33, VC{0x89, 0x89, 0xca} );
-	mailRead( 0x33, 1 ); //EXPECTED {0xee}
-	mailWrite( 0x33, VC{0x89, 0x89, 0xe7} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x49}
-	mailWrite( 0x44, VC{0x03, 0x2a} );
-	mailWrite( 0x44, VC{0x05, 0x89} );
+	runInit( "deviceBlockA", InitSequence::deviceBlockA );
 
 	//This is an educated guess right now as to why it
 	//set one way or the other. Currently it presumed
@@ -298,327 +281,20 @@ void GCHD::configureDevice()
 		mailWrite( 0x44, VC{0x08, 0x9b} );
 		mailWrite( 0x44, VC{0x09, 0x7a} );
 	}
-	mailWrite( 0x44, VC{0x19, 0xde} );
-	mailWrite( 0x44, VC{0x1a, 0x87} );
-	mailWrite( 0x44, VC{0x1b, 0x88} );
-	mailWrite( 0x44, VC{0x29, 0x8b} );
-	mailWrite( 0x44, VC{0x2d, 0x8f} );
-	mailWrite( 0x44, VC{0x4c, 0x89} );
-	mailWrite( 0x44, VC{0x55, 0x88} );
-	mailWrite( 0x44, VC{0x6b, 0xae} );
-	mailWrite( 0x44, VC{0x6c, 0xbe} );
-	mailWrite( 0x44, VC{0x6d, 0x78} );
-	mailWrite( 0x44, VC{0x6e, 0xa0} );
-	mailWrite( 0x44, VC{0x06, 0x08} );
-
-	//Potential subroutine
-	{
-		mailWrite( 0x44, VC{0x02, 0xc9} );
-		mailWrite( 0x44, VC{0x14, 0xd2} );
-		mailWrite( 0x44, VC{0x3c, 0x6b} );
-		mailWrite( 0x33, VC{0x89, 0x89, 0xfa} );
-		mailRead( 0x33, 1 ); //EXPECTED {0xfd}
-	}
-	mailWrite( 0x44, VC{0x28, 0x88} );
-	mailWrite( 0x44, VC{0x10, 0x88} );
-	mailWrite( 0x44, VC{0x11, 0xd4} );
-	mailWrite( 0x44, VC{0x12, 0xd0} );
-	mailWrite( 0x44, VC{0x13, 0x08} );
-	mailWrite( 0x44, VC{0x14, 0x08} );
-	mailWrite( 0x44, VC{0x15, 0x88} );
-	mailWrite( 0x33, VC{0x94, 0x47, 0xf9} );
-	mailWrite( 0x33, VC{0x94, 0x40, 0xf3} );
-	mailWrite( 0x33, VC{0x94, 0x43, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x4e, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x4f, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x48, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x49, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x58, 0x77} );
-	mailWrite( 0x33, VC{0x94, 0x40, 0xf1} );
-	mailWrite( 0x33, VC{0x94, 0x4d, 0xf5} );
-	mailWrite( 0x33, VC{0x94, 0x4a, 0xaf} );
-	mailWrite( 0x33, VC{0x94, 0x4b, 0xaf} );
-	mailWrite( 0x33, VC{0x94, 0x5c, 0xb7} );
-	mailWrite( 0x33, VC{0x94, 0x46, 0xd7} );
-
-	readDevice0x9DCD(0x88); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0xb7, 0xce} );
-	mailWrite( 0x4e, VC{0x41, 0xa3} );
-	mailWrite( 0x4e, VC{0xb8, 0xcc} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x00, 0xcd} );
-	mailWrite( 0x4e, VC{0x0f, 0xce} );
-	mailWrite( 0x4e, VC{0x16, 0xfc} );
-	mailWrite( 0x4e, VC{0x17, 0xcc} );
-	mailWrite( 0x4e, VC{0x18, 0xcc} );
-	mailWrite( 0x4e, VC{0x19, 0xcc} );
-	mailWrite( 0x4e, VC{0x1a, 0x9c} );
-	readDevice0x9DCD(0x15); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x2a, 0xcb} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb3
-	mailWrite( 0x4e, VC{0x00, 0xce} );
-	mailWrite( 0x4e, VC{0x08, 0xcf} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0x00, 0xcd} );
+	runInit( "deviceBlockB", InitSequence::deviceBlockB );
 	if ( deviceType_ == DeviceType::GameCaptureHDNew )
 	{
 		mailWrite( 0x4e, VC{0x24, 0x8c} );
 	} else {
 		mailWrite( 0x4e, VC{0x24, 0x8d} );
 	}
-	mailWrite( 0x4e, VC{0x25, 0xcc} );
-	mailWrite( 0x4e, VC{0x30, 0x4c} );
-	mailWrite( 0x4e, VC{0x31, 0xcc} );
-	mailWrite( 0x4e, VC{0x32, 0xcc} );
-	mailWrite( 0x4e, VC{0x25, 0xcc} );
-	mailWrite( 0x4e, VC{0x26, 0xcc} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb3
-	mailWrite( 0x4e, VC{0x00, 0xcc} );
-	mailWrite( 0x4e, VC{0xb0, 0xe8} );
-	readDevice0x9DCD(0x91); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0xae, 0xc8} );
-	mailWrite( 0x4e, VC{0xb1, 0x0c} );
-	mailWrite( 0x4e, VC{0xb2, 0xcc} );
-	mailWrite( 0x4e, VC{0xb3, 0xcc} );
-	mailWrite( 0x4e, VC{0xb4, 0x99} );
-	readDevice0x9DCD(0x8b); //EXPECTED 0xe7
-	mailWrite( 0x4e, VC{0xb4, 0x98} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x00, 0xce} );
-	mailWrite( 0x4e, VC{0x01, 0xad} );
-	mailWrite( 0x4e, VC{0x02, 0x39} );
-	readDevice0x9DCD(0x3c); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x03, 0xce} );
-	mailWrite( 0x4e, VC{0x04, 0xcd} );
-	mailWrite( 0x4e, VC{0x05, 0xcc} );
-	mailWrite( 0x4e, VC{0x06, 0xc4} );
-	mailWrite( 0x4e, VC{0x1c, 0xd6} );
-	mailWrite( 0x4e, VC{0x1d, 0xcc} );
-	mailWrite( 0x4e, VC{0x1e, 0xcc} );
-	mailWrite( 0x4e, VC{0x1f, 0xcc} );
-	readDevice0x9DCD(0x1a); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x25, 0x6e} );
-	readDevice0x9DCD(0x3d); //EXPECTED 0x47
-	mailWrite( 0x4e, VC{0x02, 0x39} );
-	readDevice0x9DCD(0x38); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x07, 0xc8} );
-	mailWrite( 0x4e, VC{0x17, 0x0c} );
-	mailWrite( 0x4e, VC{0x19, 0x33} );
-	mailWrite( 0x4e, VC{0x1a, 0x33} );
-	mailWrite( 0x4e, VC{0x1b, 0x30} );
-	mailWrite( 0x4e, VC{0x20, 0xcc} );
-	readDevice0x9DCD(0x1e); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x21, 0xcc} );
-	mailWrite( 0x4e, VC{0x22, 0xea} );
-	mailWrite( 0x4e, VC{0x27, 0xcc} );
-	readDevice0x9DCD(0x11); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x2e, 0x6d} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xfa} );
-	mailRead( 0x33, 1 ); //EXPECTED {0xa4}
-	mailWrite( 0x33, VC{0x99, 0x89, 0xf9} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x7f}
-	mailWrite( 0x33, VC{0x99, 0x89, 0xf8} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x78}
-	mailWrite( 0x33, VC{0x99, 0x89, 0xfe} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x0e}
-	mailWrite( 0x4c, VC{0x05, 0x88} );
-	mailWrite( 0x4c, VC{0x04, 0xb5} );
-	mailWrite( 0x4c, VC{0x04, 0x95} );
-	mailWrite( 0x4c, VC{0x61, 0xb8} );
-	mailWrite( 0x4c, VC{0x09, 0x3a} );
-	mailWrite( 0x4c, VC{0x0a, 0x70} );
-	mailWrite( 0x4c, VC{0x0b, 0xbf} );
-	mailWrite( 0x4c, VC{0xc9, 0x88} );
-	mailWrite( 0x4c, VC{0xca, 0x88} );
-	mailWrite( 0x4c, VC{0xcb, 0x88} );
-	mailWrite( 0x4c, VC{0xcc, 0x88} );
-	mailWrite( 0x4c, VC{0xcd, 0x88} );
-	mailWrite( 0x4c, VC{0xce, 0x88} );
-	mailWrite( 0x4c, VC{0xcf, 0x88} );
-	mailWrite( 0x4c, VC{0xd0, 0x88} );
+	runInit( "deviceBlockC", InitSequence::deviceBlockC );
 
 	if ( deviceType_ == DeviceType::GameCaptureHDNew )
 	{
-		mailWrite( 0x33, VC{0x21, 0x01, 0x72} );
-		mailRead( 0x33, 1 ); //EXPECTED {0xf4}
-		mailWrite( 0x33, VC{0x20, 0x02, 0x63} );
-		mailWrite( 0x33, VC{0x20, 0x03, 0x63} );
-		mailWrite( 0x33, VC{0x20, 0x04, 0x77} );
-		mailWrite( 0x33, VC{0x20, 0x05, 0x73} );
-		mailWrite( 0x33, VC{0x20, 0x06, 0x73} );
-		mailWrite( 0x33, VC{0x20, 0x07, 0x33} );
-		mailWrite( 0x33, VC{0x20, 0x08, 0x31} );
-		mailWrite( 0x33, VC{0x20, 0x09, 0x33} );
-		mailWrite( 0x33, VC{0x20, 0x0a, 0x57} );
-		mailWrite( 0x33, VC{0x20, 0x0b, 0x7b} );
-		mailWrite( 0x33, VC{0x20, 0x0c, 0xf7} );
-		mailWrite( 0x33, VC{0x20, 0x0d, 0xf7} );
-		mailWrite( 0x33, VC{0x20, 0x0e, 0x73} );
-		mailWrite( 0x33, VC{0x20, 0x0f, 0x73} );
+		runInit( "deviceBlockHDNew", InitSequence::deviceBlockHDNew );
 	}
-	mailWrite( 0x33, VC{0xaa, 0x8f, 0x3b} );
-
-
-	//----------------------------------------------------------
-
-	//The next set of writes and the laster 56 byte reads
-	//are not understood at  all.
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x03, 0x76} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x76} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x73, 0x76} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xab, 0x76} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x76} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x77} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x53, 0x77} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x77} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x77} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xfb, 0x77} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x33, 0x74} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x6b, 0x74} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xa3, 0x74} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xdb, 0x74} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x13, 0x75} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x4b, 0x75} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x83, 0x75} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xbb, 0x75} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xf3, 0x75} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x2b, 0x72} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x63, 0x72} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x9b, 0x72} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xd3, 0x72} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x0b, 0x73} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x43, 0x73} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x7b, 0x73} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xb3, 0x73} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xeb, 0x73} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x23, 0x70} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x5b, 0x70} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x93, 0x70} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xcb, 0x70} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x03, 0x71} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x71} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x73, 0x71} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xab, 0x71} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x71} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x7e} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x53, 0x7e} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x7e} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x7e} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xfb, 0x7e} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x33, 0x7f} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x6b, 0x7f} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xa3, 0x7f} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xdb, 0x7f} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x13, 0x7c} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x4b, 0x7c} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x83, 0x7c} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xbb, 0x7c} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xf3, 0x7c} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x2b, 0x7d} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x63, 0x7d} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x9b, 0x7d} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xd3, 0x7d} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x0b, 0x7a} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x43, 0x7a} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x7b, 0x7a} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xb3, 0x7a} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xeb, 0x7a} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x23, 0x7b} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x5b, 0x7b} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x93, 0x7b} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xcb, 0x7b} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x03, 0x78} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x78} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x73, 0x78} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xab, 0x78} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x78} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x79} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x53, 0x79} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x79} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x79} );
-	mailRead( 0x33, 56 );
-	mailWrite( 0x33, VC{0xab, 0xa2, 0x3e, 0xb4, 0xfb, 0x79} );
-
-
-	mailRead( 0x33, 8 ); //EXPECTED {0xe9, 0x5c, 0xcf, 0x42, 0xb5, 0x28, 0x9b, 0x0e}
-	mailWrite( 0x33, VC{0xaa, 0x8d, 0x35} );
+	runInit( "deviceBlockD", InitSequence::deviceBlockD );
 	for (int i=0; i<5; ++i) {
 		mailWrite( 0x33, {0xab, 0xa9, 0x0f, 0xa4, 0x5b} );
 		input=mailRead( 0x33, 3 ); /* read 3 bytes from 0x33 */
@@ -719,7 +395,7 @@ void GCHD::uninitDevice()
 		//No idea what this is, but presumably selects proper bank.
 		//Seems to be always done before configuring the transcoder with
 		//sparam commands.
-		write_config<uint16_t>(BANKSEL, 0x0000);
+		selectBank(0x0000);
 		readEnableState(); //EXPECTED 0xd39e HD NEW. 0x31e on HD
 
 		read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER); //seems no reason for this read..
@@ -847,33 +523,12 @@ void GCHD::configureColorSpace()
 
 void GCHD::configureSetupSubblock()
 {
-	mailWrite( 0x33, VC{0x99, 0x89, 0x8b} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6e}
+	runInit( "setupSubblock", InitSequence::setupSubblock );
 
 	switch(currentInputSettings_.getSource())
 	{
 		case InputSource::HDMI:
-			mailWrite( 0x4c, VC{0x70, 0xc8} );
-			mailWrite( 0x4c, VC{0x90, 0x88} );
-			mailWrite( 0x4c, VC{0x91, 0x77} );
-			mailWrite( 0x4c, VC{0x92, 0x77} );
-			mailWrite( 0x4c, VC{0x93, 0x77} );
-			mailWrite( 0x4c, VC{0x94, 0x77} );
-			mailWrite( 0x4c, VC{0x95, 0x77} );
-			mailWrite( 0x4c, VC{0x96, 0x77} );
-			mailWrite( 0x4c, VC{0x97, 0x77} );
-			mailWrite( 0x4c, VC{0x98, 0x77} );
-			mailWrite( 0x4c, VC{0x99, 0x77} );
-			mailWrite( 0x4c, VC{0x9a, 0x77} );
-			mailWrite( 0x4c, VC{0x9b, 0x77} );
-			mailWrite( 0x4c, VC{0x9c, 0x77} );
-			mailWrite( 0x4c, VC{0x9d, 0x77} );
-			mailWrite( 0x4c, VC{0x9e, 0x77} );
-			mailWrite( 0x4c, VC{0x9f, 0x77} );
-			mailWrite( 0x4c, VC{0xa0, 0x77} );
-			mailWrite( 0x4c, VC{0xa1, 0x77} );
-			mailWrite( 0x4c, VC{0xa2, 0x77} );
-			mailWrite( 0x4c, VC{0xa3, 0x77} );
+			runInit( "setupSubblockHDMI", InitSequence::setupSubblockHDMI );
 			break;
 
 			//576i and 480i have the same setup on Component and Composite
@@ -883,96 +538,26 @@ void GCHD::configureSetupSubblock()
 			{
 				case Resolution::HD1080:
 					if( currentInputSettings_.getScanMode()==ScanMode::Interlaced) {
-						mailWrite( 0x4c, VC{0x70, 0xc0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0xae} );
-						mailWrite( 0x4c, VC{0x91, 0xc2} );
-						mailWrite( 0x4c, VC{0x95, 0xde} );
-						mailWrite( 0x4c, VC{0x96, 0x0a} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x8a} );
-						mailWrite( 0x4c, VC{0xa1, 0xf8} );
-						mailWrite( 0x4c, VC{0xa2, 0xbc} );
-						mailWrite( 0x4c, VC{0xa3, 0x1a} );
+						runInit( "setupSubblock1080i", InitSequence::setupSubblock1080i );
 					} else { //Assuming HD1080p30
-						mailWrite( 0x4c, VC{0x70, 0xc0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0x7e} );
-						mailWrite( 0x4c, VC{0x91, 0x77} );
-						mailWrite( 0x4c, VC{0x95, 0xde} );
-						mailWrite( 0x4c, VC{0x96, 0x0a} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x8c} );
-						mailWrite( 0x4c, VC{0xa1, 0x18} );
-						mailWrite( 0x4c, VC{0xa2, 0x77} );
-						mailWrite( 0x4c, VC{0xa3, 0x77} );
+						runInit( "setupSubblock1080p", InitSequence::setupSubblock1080p );
 					}
 					break;
 				case Resolution::HD720:
-					mailWrite( 0x4c, VC{0x70, 0xc0} );
-					mailWrite( 0x4c, VC{0x0f, 0x88} );
-					mailWrite( 0x4c, VC{0x90, 0xfe} );
-					mailWrite( 0x4c, VC{0x91, 0xbb} );
-					mailWrite( 0x4c, VC{0x95, 0xe4} );
-					mailWrite( 0x4c, VC{0x96, 0x1c} );
-					mailWrite( 0x4c, VC{0x97, 0x88} );
-					mailWrite( 0x4c, VC{0xa0, 0x8d} );
-					mailWrite( 0x4c, VC{0xa1, 0x28} );
-					mailWrite( 0x4c, VC{0xa2, 0x77} );
-					mailWrite( 0x4c, VC{0xa3, 0x77} );
+					runInit( "setupSubblock720p", InitSequence::setupSubblock720p );
 					break;
 				case Resolution::PAL:
 					if( currentInputSettings_.getScanMode()==ScanMode::Interlaced) {
-						mailWrite( 0x4c, VC{0x70, 0xd0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0xd8} );
-						mailWrite( 0x4c, VC{0x91, 0xbf} );
-						mailWrite( 0x4c, VC{0x95, 0x9d} );
-						mailWrite( 0x4c, VC{0x96, 0x1b} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x8a} );
-						mailWrite( 0x4c, VC{0xa1, 0xd8} );
-						mailWrite( 0x4c, VC{0xa2, 0xb2} );
-						mailWrite( 0x4c, VC{0xa3, 0x59} );
+						runInit( "setupSubblock576i", InitSequence::setupSubblock576i );
 					} else {
-						mailWrite( 0x4c, VC{0x70, 0xc0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0x28} );
-						mailWrite( 0x4c, VC{0x91, 0x93} );
-						mailWrite( 0x4c, VC{0x95, 0x82} );
-						mailWrite( 0x4c, VC{0x96, 0xc2} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x8d} );
-						mailWrite( 0x4c, VC{0xa1, 0x28} );
-						mailWrite( 0x4c, VC{0xa2, 0x77} );
-						mailWrite( 0x4c, VC{0xa3, 0x77} );
+						runInit( "setupSubblock576p", InitSequence::setupSubblock576p );
 					}
 					break;
 				case Resolution::NTSC:
 					if( currentInputSettings_.getScanMode()==ScanMode::Interlaced) {
-						mailWrite( 0x4c, VC{0x70, 0xd0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0x68} );
-						mailWrite( 0x4c, VC{0x91, 0xbf} );
-						mailWrite( 0x4c, VC{0x95, 0xab} );
-						mailWrite( 0x4c, VC{0x96, 0x17} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x8c} );
-						mailWrite( 0x4c, VC{0xa1, 0xf8} );
-						mailWrite( 0x4c, VC{0xa2, 0x82} );
-						mailWrite( 0x4c, VC{0xa3, 0x59} );
+						runInit( "setupSubblock480i", InitSequence::setupSubblock480i );
 					} else {
-						mailWrite( 0x4c, VC{0x70, 0xc0} );
-						mailWrite( 0x4c, VC{0x0f, 0x88} );
-						mailWrite( 0x4c, VC{0x90, 0x78} );
-						mailWrite( 0x4c, VC{0x91, 0xb9} );
-						mailWrite( 0x4c, VC{0x95, 0x86} );
-						mailWrite( 0x4c, VC{0x96, 0xc4} );
-						mailWrite( 0x4c, VC{0x97, 0x88} );
-						mailWrite( 0x4c, VC{0xa0, 0x81} );
-						mailWrite( 0x4c, VC{0xa1, 0x78} );
-						mailWrite( 0x4c, VC{0xa2, 0x77} );
-						mailWrite( 0x4c, VC{0xa3, 0x77} );
+						runInit( "setupSubblock480p", InitSequence::setupSubblock480p );
 					}
 					break;
 
@@ -989,116 +574,12 @@ void GCHD::configureSetupSubblock()
 
 void GCHD::configureCommonBlockA()
 {
-	mailWrite( 0x33, VC{0x99, 0x89, 0xfd} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6e}
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0x88} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32);
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0xa8} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32);
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0xc8} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x2b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0x6f, 0x73, 0x6e, 0x1c, 0x3f, 0xbe, 0x70, 0x4e, 0x00, 0x46, 0x3b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0x6e, 0x6e, 0x6e, 0x93, 0x6e, 0x5c}
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0xe8} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x52, 0x70, 0x3f, 0x7f, 0x6e, 0x64, 0x4e, 0x4e, 0x4e, 0x4e, 0x4e, 0x4e, 0x6e, 0x6e, 0x6e, 0x92, 0x6e, 0x3d, 0x17, 0x00, 0x0d, 0x23, 0x0f, 0x1d, 0x1a, 0x0b, 0x1c, 0x64, 0x4e, 0x4e, 0x6f, 0xfa}
-
-	mailWrite( 0x33, VC{0x99, 0x89, 0xfd} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6e}
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0x08} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x6c, 0x6d, 0x72, 0x9f, 0x26, 0xfe, 0x6a, 0x71, 0x6b, 0x7a, 0x7d, 0x6d, 0x7c, 0x4d, 0x67, 0x69, 0x69, 0xed, 0x6f, 0x6e, 0x6e, 0x08, 0x6d, 0x62, 0x6e, 0x7e, 0x6e, 0xee, 0x6f, 0x73, 0xee, 0xbe}
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0x28} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x1c, 0x72, 0x78, 0x4e, 0x7e, 0x42, 0x4b, 0xee, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0xf0, 0x6f, 0x73, 0xee, 0x76, 0x1f, 0x72, 0x78, 0x4e, 0x36, 0x42, 0x4b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0xf0}
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0x48} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x6f, 0x73, 0x6e, 0xd2, 0x3c, 0xbe, 0x70, 0x4e, 0xd6, 0x46, 0x3b, 0x2e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0xe2, 0x64, 0xbe, 0xfe, 0x4e, 0x2e, 0x5f, 0x4e, 0x62, 0x2e, 0x3b, 0x6e, 0xce, 0x34}
-	mailWrite( 0x4c, VC{0x15, 0x81} );
-	mailWrite( 0x4c, VC{0x65, 0x8a} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0x28} );
-	mailWrite( 0x4c, VC{0x12, 0x68} );
-	mailWrite( 0x4c, VC{0x13, 0xa8} );
-	mailWrite( 0x4c, VC{0x14, 0x88} );
-	mailWrite( 0x4c, VC{0x15, 0x8b} );
-	pollOn0x9989ED();
-	readFrom0x9989EC(32); //EXPECTED {0x6e, 0x6e, 0x6e, 0x76, 0xe2, 0x64, 0xbe, 0xe4, 0x4e, 0x8e, 0x43, 0x7e, 0x7e, 0x50, 0xf8, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x76, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x28}
+	runInit( "commonBlockA", InitSequence::commonBlockA );
 
 	if ( deviceType_ == DeviceType::GameCaptureHD ) {
 		configureCommonBlockC(); //Think this is just a driver choice to move it to just doing it at the end on newer model
 	}
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0x10, 0x89} );
-	mailWrite( 0x4c, VC{0x11, 0xfc} );
-	mailWrite( 0x4c, VC{0x12, 0xc8} );
-	mailWrite( 0x4c, VC{0x13, 0x8b} );
-	mailWrite( 0x4c, VC{0x15, 0x88} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xed} );
-	mailRead( 0x33, 1 ); //EXPECTED {0xec}
-	mailWrite( 0x33, VC{0x99, 0x8a, 0xbf} );
-	mailRead( 0x33, 2 ); //EXPECTED {0x6e, 0xe1}
+	runInit( "commonBlockAPost", InitSequence::commonBlockAPost );
 	mailWrite( 0x33, VC{0x99, 0x89, 0xb8} );
 	std::vector<uint8_t> readValue=mailRead( 0x33, 1 );
 
@@ -1295,18 +776,7 @@ void GCHD::configureCommonBlockB2()
 	//previous 2 statements
 	//in some captures.
 
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0xc1, 0x89} );
-	mailWrite( 0x4c, VC{0xc6, 0x8b} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0x61, 0x88} );
-
-	mailWrite( 0x33, VC{0x10, 0x00, 0x33} );
-	mailWrite( 0x33, VC{0x10, 0x01, 0xe3} );
-	mailWrite( 0x33, VC{0x10, 0x02, 0x71} );
-	mailWrite( 0x33, VC{0x10, 0x03, 0x72} );
-	mailWrite( 0x33, VC{0x10, 0x01, 0x63} );
-	mailWrite( 0x4c, VC{0x0f, 0x89} );
+	runInit( "commonBlockB2Middle", InitSequence::commonBlockB2Middle );
 
 	switch(currentInputSettings_.getResolution()) {
 		case Resolution::HD1080:
@@ -1331,139 +801,19 @@ void GCHD::configureCommonBlockB2()
 			throw runtime_error( "Current selected video mode is not a supported mode.");
 			break;
 	}
-	mailWrite( 0x4c, VC{0x35, 0x88} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0xc5, 0x88} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xa3} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x7f}
-	mailWrite( 0x4c, VC{0x58, 0x9d} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xff} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6b}
-	mailWrite( 0x4c, VC{0x04, 0x8d} );
-	mailWrite( 0x4c, VC{0xe2, 0x6c} );
-	mailWrite( 0x4c, VC{0xe3, 0x88} );
-	mailWrite( 0x4c, VC{0xe4, 0x80} );
-	mailWrite( 0x4c, VC{0xe0, 0x49} );
-	mailWrite( 0x4c, VC{0xe1, 0x89} );
-	mailWrite( 0x4c, VC{0x0f, 0x89} );
-	mailWrite( 0x4c, VC{0x91, 0x88} );
-	mailWrite( 0x4c, VC{0x92, 0x88} );
-	mailWrite( 0x4c, VC{0x93, 0x89} );
-	mailWrite( 0x4c, VC{0x94, 0xa9} );
-	mailWrite( 0x4c, VC{0x95, 0xcb} );
-	mailWrite( 0x4c, VC{0x96, 0xed} );
-	mailWrite( 0x4c, VC{0x97, 0x0f} );
-	mailWrite( 0x4c, VC{0x98, 0x8a} );
-	mailWrite( 0x4c, VC{0x99, 0x53} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xff} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6b}
-	mailWrite( 0x4c, VC{0x04, 0x8c} );
-	mailWrite( 0x4c, VC{0x0f, 0x89} );
-	mailWrite( 0x4c, VC{0x68, 0x89} );
-	mailWrite( 0x4c, VC{0x6b, 0x88} );
-	mailWrite( 0x4c, VC{0x6c, 0x88} );
-	mailWrite( 0x4c, VC{0x6d, 0xf8} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0xce, 0x8b} );
-	mailWrite( 0x33, VC{0x99, 0x89, 0xff} );
-	mailRead( 0x33, 1 ); //EXPECTED {0x6a}
-	mailWrite( 0x4c, VC{0x04, 0x88} );
-	mailWrite( 0x4c, VC{0x0f, 0x88} );
-	mailWrite( 0x4c, VC{0xc1, 0x88} );
-	mailWrite( 0x4c, VC{0xc6, 0x8b} );
+	runInit( "commonBlockB2Tail", InitSequence::commonBlockB2Tail );
 }
 
 void GCHD::configureCommonBlockB3()
 {
 	if (currentInputSettings_.getResolution() != Resolution::PAL) {
-		mailWrite( 0x4c, VC{0x0f, 0x89} );
-		mailWrite( 0x33, VC{0x99, 0x89, 0x5b} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x7c}
-		mailWrite( 0x33, VC{0x99, 0x89, 0x5a} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x2a}
-		mailWrite( 0x33, VC{0x99, 0x89, 0x59} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x6c}
-
-		mailWrite( 0x33, VC{0x99, 0x89, 0xc8} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x6e}
-		mailWrite( 0x33, VC{0x99, 0x89, 0xcf} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x76}
-		mailWrite( 0x33, VC{0x99, 0x89, 0xce} );
-		mailRead( 0x33, 1 ); //EXPECTED {0x6e};
-		mailWrite( 0x4c, VC{0x0f, 0x88} );
+		runInit( "commonBlockB3", InitSequence::commonBlockB3 );
 	}
 }
 
 void GCHD::configureCommonBlockC()
 {
-	mailWrite( 0x33, VC{0xaa, 0xb8, 0x29, 0xf6} );
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x73} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0xa6, 0x33, 0xc0, 0x4d, 0xda, 0x67, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x7b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xf2, 0xb8, 0xcd, 0x3f, 0xb2, 0x25, 0x98, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x63} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xf7, 0x4e, 0xcd, 0x3c, 0x32, 0x25, 0x9a, 0x73}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x6b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xfc, 0x96, 0xb8, 0x9c, 0xe5, 0x69, 0x28, 0x28}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x53} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xef, 0x11, 0x80, 0x3f, 0xb2, 0x25, 0x19, 0xcb}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x5b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x37, 0x99, 0xcd, 0x3e, 0xb3, 0x24, 0x99, 0x0a}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x43} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe7, 0x58, 0xcd, 0x3e, 0xb3, 0x24, 0x9a, 0x31}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x4b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x66, 0x41, 0xbd, 0x07, 0x9f, 0x65, 0xc0, 0x27}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x33} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xa3, 0x59, 0x08, 0xb1, 0x93, 0x25, 0x98, 0x15}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x3b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0x59, 0xcc, 0x27, 0xb2, 0x39, 0x8e, 0x2b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x23} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xbe, 0x75, 0xe9, 0x3f, 0x76, 0xab, 0xb9, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x2b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0xc7, 0xcc, 0x3f, 0xb2, 0xd9, 0x98, 0x4e}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x13} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x8a, 0x3e, 0xad, 0x4b, 0xdd, 0x2f, 0xb8, 0x2b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x1b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xc6, 0x79, 0xec, 0x1f, 0xb2, 0x25, 0x98, 0xf6}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x03} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0x4e, 0xf1, 0x26, 0xf4, 0x2a, 0x98, 0x01}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x0b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xc6, 0x79, 0xec, 0x1f, 0x92, 0x05, 0x99, 0xee}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xf3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe4, 0x5a, 0xea, 0xcb, 0xe3, 0xa0, 0x9c, 0x08}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xfb} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe4, 0x4b, 0xdf, 0xab, 0xa4, 0x22, 0x9e, 0x1a}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xe3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xf3, 0xf8, 0x6e, 0x18, 0xad, 0x35, 0xbb, 0x02}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xeb} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe1, 0x58, 0x4f, 0x3e, 0xb2, 0x25, 0xff, 0x08}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xd3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xea, 0x59, 0xdc, 0x3f, 0x92, 0x08, 0x14, 0x01}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xdb} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x46, 0x4d, 0x9d, 0xcf, 0xa4, 0x25, 0xbe, 0x77}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xc3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xa5, 0x59, 0x08, 0xb1, 0x93, 0x25, 0x98, 0x93}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xcb} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x6a, 0x53, 0x1c, 0xb5, 0x92, 0xc5, 0xb5, 0x1b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xb3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xf6, 0x67, 0x5a, 0x3f, 0x76, 0xab, 0xb9, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xbb} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0x40, 0xcd, 0x22, 0xb2, 0x57, 0xc9, 0xdb}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xa3} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xf8, 0x79, 0xa2, 0x17, 0xe7, 0x25, 0x5c, 0x85}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0xab} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xc7, 0x59, 0xcc, 0x20, 0xb3, 0x38, 0x18, 0x13}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x93} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x97, 0x45, 0xda, 0x1f, 0xea, 0x09, 0xbd, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x9b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0x22, 0xd7, 0xed, 0x3f, 0xb2, 0xbb, 0x98, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x83} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0x59, 0xcc, 0x3f, 0xb2, 0x25, 0x98, 0x0b}
-	mailWrite( 0x33, VC{0xa1, 0x08, 0x8b} );
-	mailRead( 0x33, 8 ); //EXPECTED {0xe6, 0x59, 0xcc, 0x3f, 0xb2, 0x25, 0x98, 0x04}
-	mailWrite( 0x33, VC{0xaa, 0xb8, 0x29, 0xe7} );
+	runInit( "commonBlockC", InitSequence::commonBlockC );
 }
 
 
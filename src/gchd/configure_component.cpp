@@ -9,20 +9,16 @@
 #include <exception>
 #include <cmath>
 #include "../gchd.hpp"
+#include "init_sequences.hpp"
 
 //make sure on bank 0x4e, (0x00, 0xcc) before using.
-void GCHD::readComponentSignalInformation(unsigned &sum6867, unsigned &countSum6867,
-					  unsigned &sum6665, unsigned &countSum6665)
+void GCHD::readComponentSignalInformation(unsigned &value6867, unsigned &value6665)
 {
-	unsigned value6665  = readDevice0x9DCD(0x66) <<8;
+	value6665  = readDevice0x9DCD(0x66) <<8;
 	value6665 |= readDevice0x9DCD(0x65);
-	sum6665 += value6665;
-	countSum6665 += 1;
 
-	unsigned value6867  = readDevice0x9DCD(0x68) <<8;
+	value6867  = readDevice0x9DCD(0x68) <<8;
 	value6867 |= readDevice0x9DCD(0x67);
-	sum6867 += value6867;
-	countSum6867 += 1;
 
 	//register 0x60 might contain interlacing information.
 	// 0xbd for HD1080i60/0xb8 for 576i60/0xb2 for 1080p30, 576p60
@@ -30,82 +26,25 @@ void GCHD::readComponentSignalInformation(unsigned &sum6867, unsigned &countSum6
 
 void GCHD::configureComponent()
 {
-	mailWrite( 0x33, VC{0x94, 0x41, 0x37} );
-	mailWrite( 0x33, VC{0x94, 0x4a, 0xaf} );
-	mailWrite( 0x33, VC{0x94, 0x4b, 0xaf} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0x00, 0xcc} );
-	readDevice0x9DCD(0x94); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0xab, 0x4c} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x00, 0xce} );
-	mailWrite( 0x4e, VC{0x1b, 0x33} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0x00, 0xcc} );
-	readDevice0x9DCD(0x88); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0xb7, 0xce} );
-	mailWrite( 0x4e, VC{0xb8, 0xdc} );
-	mailWrite( 0x4e, VC{0xb8, 0xcc} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb2
-	mailWrite( 0x4e, VC{0x00, 0xce} );
-	mailWrite( 0x4e, VC{0x07, 0x38} );
-	mailWrite( 0x4e, VC{0x07, 0xc8} );
-	readDevice0x9DCD(0x3f); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0x00, 0xcc} );
-	mailWrite( 0x4e, VC{0x51, 0xed} ); //Changed from HDMI.
-	readDevice0x9DCD(0x88); //EXPECTED 0xb0
-	mailWrite( 0x4e, VC{0xb7, 0xce} ); //Changed from HDMI
-
-	//Do nothing enable. No idea what it really checks
-	doEnable( 0x0000, 0x0000); //state 031e->031e, enable 000a->000a
-
-	mailWrite( 0x4e, VC{0x24, 0x0c} );
-	mailWrite( 0x4e, VC{0x21, 0xcd} );
-	mailWrite( 0x4e, VC{0x91, 0xc8} );
-	mailWrite( 0x4e, VC{0x0e, 0x8c} );
-	mailWrite( 0x4e, VC{0x11, 0xec} );
-	mailWrite( 0x4e, VC{0x71, 0x4c} );
-	mailWrite( 0x4e, VC{0x04, 0xcc} ); //THIS HAS DIFFERENT VALUE
+	runInit( "componentBlockA", InitSequence::componentBlockA );
 	//For non-1080 captures, but I have no idea where and how they
 	//detect it, or what setting it is based on.
 	//Leaving it 0xcc right now for all and hoping it still works
 
 	//MODE AUTODETECT IS HERE
-	unsigned sum6867=0;
-	unsigned sum6665=0;
-	unsigned countSum6867=0;
-	unsigned countSum6665=0;
-	double value6665;
-
-	unsigned iterationCount=0;
-	do {
-		if(iterationCount >= 10) { //Roughly 2 seconds given usleep below, after firmware load.
-			throw runtime_error( "No HDMI signal found.");
-		}
-		sum6665=0;
-		sum6867=0;
-		countSum6665=0;
-		countSum6867=0;
-
-		for( unsigned j = 0; j<10; ++j ) { //Read 10 times for average. Probably not at all necessary.
-			readComponentSignalInformation(sum6867, countSum6867, sum6665, countSum6665);
-		}
-		value6665=((double)sum6665) / countSum6665;
-
-		usleep( 1000000 / 5 ); //1/5th of a second, long enough time for more than four frames at low frame rate.
-		//Enough time to lock
-
-		iterationCount+=1;
-	} while( (iterationCount < 3) || (std::abs( value6665 - 0xad4d )<10.0) );
-	//^^^^^ Need to go through loop at least twice, to stabilize read, and value read must not be value
-	//gotten when no signal
+	SignalDetector detector;
+	WaitStats detection = detectSignal( "Component", detector, [&](unsigned &signal, unsigned &mode) {
+		readComponentSignalInformation(mode, signal);
+	});
+	inputSignal_ = detector.getSignal();
+	inputMode_ = detector.getMode();
 
 	Resolution autodetectResolution=Resolution::Unknown;
 	ScanMode autodetectScanMode=ScanMode::Progressive; //Just defaults to progressive in absence of other
 	//information for Component.
 	double autodetectRefreshRate=0.0;
 
-	double value6867=((double)sum6867) / countSum6867;
+	double value6867 = detector.getMode();
 	if(fabs( value6867 - 0xbbf4 )<10.0) {
 		//HD1080p30
 		autodetectResolution=Resolution::HD1080;
@@ -167,6 +106,7 @@ void GCHD::configureComponent()
 
 	//Merge passed arguments and autodetect information.
 	currentInputSettings_.mergeAutodetect( passedInputSettings_, autodetectResolution, autodetectScanMode, autodetectRefreshRate );
+	recordDetection( "Component", detection );
 	if( passedInputSettings_.getColorSpace()==ColorSpace::Unknown ) {
 		currentInputSettings_.setColorSpace( ColorSpace::YUV ); //Component=YUV unless overridden.
 	} else {
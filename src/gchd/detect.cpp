@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <cmath>
+#include <string>
+#include "../gchd.hpp"
+
+SignalDetector::SignalDetector() {
+	signalSum_ = 0.0;
+	modeSum_ = 0.0;
+	count_ = 0;
+	readings_ = 0;
+	hasSignal_ = false;
+}
+
+bool SignalDetector::add(unsigned signal, unsigned mode) {
+	auto now = std::chrono::steady_clock::now();
+	readings_++;
+	hasSignal_ = std::abs((double)signal - SIGNAL_NONE) >= 10.0;
+
+	//Anything off the average so far starts over from this reading.
+	if (!hasSignal_ || (count_ &&
+	    ((std::abs(signal - getSignal()) > SIGNAL_TOLERANCE) ||
+	     (std::abs(mode - getMode()) > SIGNAL_TOLERANCE)))) {
+		signalSum_ = 0.0;
+		modeSum_ = 0.0;
+		count_ = 0;
+	}
+	if (!hasSignal_) {
+		return false;
+	}
+	if (!count_) {
+		start_ = now;
+	}
+	signalSum_ += signal;
+	modeSum_ += mode;
+	count_++;
+
+	return (count_ >= SIGNAL_SETTLE_READS) &&
+	       (now - start_ >= std::chrono::milliseconds(SIGNAL_SETTLE_TIME));
+}
+
+bool SignalDetector::hasSignal() {
+	return hasSignal_;
+}
+
+double SignalDetector::getSignal() {
+	return count_ ? signalSum_ / count_ : 0.0;
+}
+
+double SignalDetector::getMode() {
+	return count_ ? modeSum_ / count_ : 0.0;
+}
+
+unsigned SignalDetector::getReadings() {
+	return readings_;
+}
+
+//Detection times go in with the waits, keyed by what was found, so
+//-init-stats shows how long each kind of input takes to settle.
+void GCHD::recordDetection(const char *source, const WaitStats &detection) {
+	unsigned horizontal, vertical;
+	currentInputSettings_.getResolution(horizontal, vertical);
+	bool interlaced = currentInputSettings_.getScanMode() == ScanMode::Interlaced;
+
+	WaitStats &stats = waitStats_[std::string(source) + " " + std::to_string(vertical) +
+				      (interlaced ? "i" : "p") + " signal"];
+	stats.waits += detection.waits;
+	stats.polls += detection.polls;
+	stats.seconds += detection.seconds;
+	if (detection.longest > stats.longest) {
+		stats.longest = detection.longest;
+	}
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef DETECT_H
+#define DETECT_H
+
+#include <chrono>
+
+#define SIGNAL_NONE		0xad4d // Register 0x6665 reads this with no input signal.
+#define SIGNAL_TOLERANCE	4.0 // Readings this close are the same signal.
+#define SIGNAL_SETTLE_READS	4 // Readings that must agree...
+#define SIGNAL_SETTLE_TIME	100 // ...for at least this long, in ms. A few frames at low frame rate.
+#define SIGNAL_TIMEOUT		2000 // Longest wait for the input to settle after firmware load, in ms.
+
+//Watches the input signal registers after the firmware is loaded. The
+//first reads are bad and seem to kick off the lock, so we keep reading
+//until the values stop moving, rather than waiting a fixed time.
+class SignalDetector {
+	public:
+		SignalDetector();
+
+		//Adds one reading of 0x6665 and the mode register (0x6463
+		//for HDMI, 0x6867 for Component). Returns true once
+		//readings have agreed long enough to be trusted.
+		bool add(unsigned signal, unsigned mode);
+
+		bool hasSignal(); //Last reading was not SIGNAL_NONE.
+		double getSignal(); //Averages of the readings that agreed.
+		double getMode();
+		unsigned getReadings(); //All readings, including those thrown away.
+
+	private:
+		std::chrono::steady_clock::time_point start_;
+		double signalSum_;
+		double modeSum_;
+		unsigned count_;
+		unsigned readings_;
+		bool hasSignal_;
+};
+
+#endif
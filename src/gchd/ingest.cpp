@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "../gchd.hpp"
+#include "ingest.hpp"
+
+IngestRing::IngestRing(struct libusb_device_handle *devh, unsigned char endpoint,
+		       unsigned count, unsigned capacity, unsigned size, unsigned timeout) {
+	devh_ = devh;
+	endpoint_ = endpoint;
+	capacity_ = capacity - STREAM_HEADROOM;
+	size_ = std::min(size, capacity_);
+	timeout_ = timeout;
+	head_ = 0;
+	gone_ = false;
+
+	count = std::max(count, 1u);
+	pool_ = std::make_shared<BufferPool>(count, capacity);
+
+	//Slots are handed to libusb as user_data, so this vector must never
+	//reallocate after this point.
+	slots_.resize(count);
+	for (auto &slot : slots_) {
+		slot.ring = this;
+		slot.buffer = pool_->acquire();
+		slot.completed = 1;
+		slot.submitted = false;
+		slot.transfer = libusb_alloc_transfer(0);
+		if (!slot.transfer) {
+			throw usb_error("Unable to allocate USB transfer.");
+		}
+	}
+}
+
+IngestRing::~IngestRing() {
+	stop();
+	for (auto &slot : slots_) {
+		libusb_free_transfer(slot.transfer);
+	}
+}
+
+void IngestRing::start() {
+	head_ = 0;
+	for (auto &slot : slots_) {
+		if (!slot.submitted) {
+			submit(slot);
+		}
+	}
+}
+
+void IngestRing::stop() {
+	for (auto &slot : slots_) {
+		if (slot.submitted && !slot.completed) {
+			libusb_cancel_transfer(slot.transfer);
+		}
+	}
+
+	//Cancellation is asynchronous too, libusb still owns the buffers
+	//until the callbacks have run.
+	for (auto &slot : slots_) {
+		while (slot.submitted && !slot.completed) {
+			struct timeval tv = {1, 0};
+			libusb_handle_events_timeout_completed(nullptr, &tv, &slot.completed);
+		}
+		slot.submitted = false;
+	}
+	head_ = 0;
+}
+
+size_t IngestRing::read(unsigned char *buffer, size_t size, unsigned timeout) {
+	Slot &slot = slots_[head_];
+
+	if (!slot.submitted && !submit(slot)) {
+		return 0;
+	}
+	if (!waitFor(slot, timeout)) {
+		return 0;
+	}
+
+	size_t length = std::min(size, complete(slot));
+	memcpy(buffer, slot.buffer.data(), length);
+	advance(slot);
+
+	return length;
+}
+
+void IngestRing::read(Buffer &buffer, unsigned timeout) {
+	Slot &slot = slots_[head_];
+
+	buffer.resize(0);
+	if (!slot.submitted && !submit(slot)) {
+		return;
+	}
+	if (!waitFor(slot, timeout)) {
+		return;
+	}
+
+	size_t length = complete(slot);
+	if (buffer.unique() && (buffer.capacity() >= capacity_)) {
+		slot.buffer.resize(length);
+		slot.buffer.swap(buffer);
+	} else {
+		length = std::min(length, buffer.capacity());
+		memcpy(buffer.data(), slot.buffer.data(), length);
+		buffer.resize(length);
+	}
+	advance(slot);
+}
+
+unsigned IngestRing::getCount() {
+	return slots_.size();
+}
+
+bool IngestRing::isGone() {
+	return gone_;
+}
+
+void IngestRing::setTransfer(unsigned size, unsigned timeout) {
+	size_ = std::min(size, capacity_);
+	timeout_ = timeout;
+}
+
+size_t IngestRing::complete(Slot &slot) {
+	switch (slot.transfer->status) {
+		case LIBUSB_TRANSFER_COMPLETED:
+		case LIBUSB_TRANSFER_TIMED_OUT: //Timed out transfers still carry partial data.
+			return static_cast<size_t>(slot.transfer->actual_length);
+		case LIBUSB_TRANSFER_NO_DEVICE:
+			gone_ = true;
+			return 0;
+		default:
+			return 0;
+	}
+}
+
+void IngestRing::advance(Slot &slot) {
+	//Goes to the back of the queue, behind everything already in flight.
+	slot.submitted = false;
+	submit(slot);
+	head_ = (head_ + 1) % slots_.size();
+}
+
+void LIBUSB_CALL IngestRing::callback(struct libusb_transfer *transfer) {
+	Slot *slot = static_cast<Slot *>(transfer->user_data);
+	slot->completed = 1;
+}
+
+bool IngestRing::submit(Slot &slot) {
+	slot.buffer.resize(0);
+	slot.buffer.setHeadroom(STREAM_HEADROOM);
+	libusb_fill_bulk_transfer(slot.transfer, devh_, endpoint_, slot.buffer.data(),
+				  static_cast<int>(size_), callback, &slot, timeout_);
+	slot.completed = 0;
+
+	int status = libusb_submit_transfer(slot.transfer);
+	if (status) {
+		if (status == LIBUSB_ERROR_NO_DEVICE) {
+			gone_ = true;
+		}
+		slot.completed = 1;
+		slot.submitted = false;
+		return false;
+	}
+	slot.submitted = true;
+	return true;
+}
+
+bool IngestRing::waitFor(Slot &slot, unsigned timeout) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+	while (!slot.completed) {
+		auto now = std::chrono::steady_clock::now();
+		if (now >= deadline) {
+			return false;
+		}
+		auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count();
+
+		struct timeval tv;
+		tv.tv_sec = remaining / 1000000;
+		tv.tv_usec = remaining % 1000000;
+		libusb_handle_events_timeout_completed(nullptr, &tv, &slot.completed);
+	}
+	return true;
+}
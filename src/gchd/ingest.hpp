@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef INGEST_H
+#define INGEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <libusb-1.0/libusb.h>
+
+#include "../buffer.hpp"
+
+//Keeps several asynchronous bulk transfers queued on the stream endpoint,
+//so the host controller always has a buffer to fill while we are busy
+//handing the previous one to the sinks. With a single synchronous
+//libusb_bulk_transfer the endpoint sits idle between calls, and the
+//device has to buffer everything that arrives in that gap.
+//
+//Transfers are submitted, completed and resubmitted in ring order, so
+//data always comes out in the order the device sent it.
+class IngestRing {
+	public:
+		//Buffers get capacity bytes. Transfers fill them past
+		//STREAM_HEADROOM, with size bytes at a time.
+		IngestRing(struct libusb_device_handle *devh, unsigned char endpoint,
+			   unsigned count, unsigned capacity, unsigned size, unsigned timeout);
+		~IngestRing();
+
+		void start();
+		void stop(); //Cancels everything in flight, waits for it to finish.
+
+		//Waits up to timeout milliseconds for the oldest transfer
+		//to complete, copies what it received to buffer, and
+		//resubmits it. Returns number of bytes copied.
+		size_t read(unsigned char *buffer, size_t size, unsigned timeout);
+
+		//Same, but without the copy: the transfer's storage is swapped
+		//into buffer, and buffer's storage goes back to the device.
+		//Falls back to copying if buffer is shared or too small.
+		void read(Buffer &buffer, unsigned timeout);
+
+		unsigned getCount();
+		//The device went away, IE was unplugged. Reads come back
+		//empty from then on.
+		bool isGone();
+
+		//Takes effect as transfers get resubmitted. Size is capped
+		//at what fits past the headroom.
+		void setTransfer(unsigned size, unsigned timeout);
+
+	private:
+		struct Slot {
+			IngestRing *ring;
+			struct libusb_transfer *transfer;
+			Buffer buffer;
+			int completed; //Set by callback, libusb waits on it.
+			bool submitted;
+		};
+
+		static void LIBUSB_CALL callback(struct libusb_transfer *transfer);
+		bool submit(Slot &slot);
+		bool waitFor(Slot &slot, unsigned timeout);
+		size_t complete(Slot &slot); //Bytes received by a finished transfer.
+		void advance(Slot &slot);
+
+		struct libusb_device_handle *devh_;
+		unsigned char endpoint_;
+		unsigned capacity_; //Past the headroom.
+		unsigned size_;
+		unsigned timeout_; //Per transfer timeout, so partial data gets returned.
+		unsigned head_;
+		bool gone_;
+		std::shared_ptr<BufferPool> pool_; //Initial transfer storage, later swapped around.
+		std::vector<Slot> slots_;
+};
+
+#endif
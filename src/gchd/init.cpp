@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "../gchd.hpp"
+
+void GCHD::runInit(const char *name, const InitOp *ops, size_t count)
+{
+	bool fast = deviceSettings_.getFastInit();
+	InitStats &stats = initStats_[name];
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < count; ++i) {
+		const InitOp &op = ops[i];
+		if (fast && op.isDiscardedRead()) {
+			//Skipping a query also skips its write, the answer is
+			//what was being asked for.
+			stats.skipped++;
+			continue;
+		}
+
+		switch (op.type) {
+			case InitOpType::MailWrite:
+				mailWrite(op.port, std::vector<unsigned char>(op.data, op.data + op.size));
+				break;
+			case InitOpType::MailRead:
+				mailRead(op.port, op.readSize);
+				break;
+			case InitOpType::Query:
+				mailWrite(op.port, std::vector<unsigned char>(op.data, op.data + op.size));
+				mailRead(op.port, op.readSize);
+				break;
+			case InitOpType::DeviceRead:
+				readDevice0x9DCD(op.data[0]);
+				break;
+			case InitOpType::Enable:
+				doEnable(Utility::debyteify<uint16_t>(op.data, 2),
+					 Utility::debyteify<uint16_t>(op.data + 2, 2));
+				break;
+			case InitOpType::Poll9989ED:
+				pollOn0x9989ED();
+				break;
+			case InitOpType::Read9989EC:
+				readFrom0x9989EC(op.readSize);
+				break;
+		}
+		stats.ops++;
+	}
+
+	stats.runs++;
+	stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GCHD::printInitStats()
+{
+	std::cerr << "Init sequence           runs   ops  skipped      ms" << std::endl;
+	for (auto &entry : initStats_) {
+		const InitStats &stats = entry.second;
+		std::cerr << std::left << std::setw(22) << entry.first << std::right
+			  << std::setw(6) << stats.runs
+			  << std::setw(6) << stats.ops
+			  << std::setw(9) << stats.skipped
+			  << std::setw(8) << std::fixed << std::setprecision(1) << stats.seconds * 1000.0
+			  << std::endl;
+	}
+
+	std::cerr << "Wait                   waits  polls  longest ms   total ms" << std::endl;
+	for (auto &entry : waitStats_) {
+		const WaitStats &stats = entry.second;
+		std::cerr << std::left << std::setw(22) << entry.first << std::right
+			  << std::setw(6) << stats.waits
+			  << std::setw(7) << stats.polls
+			  << std::setw(12) << std::fixed << std::setprecision(1) << stats.longest * 1000.0
+			  << std::setw(11) << stats.seconds * 1000.0
+			  << std::endl;
+	}
+}
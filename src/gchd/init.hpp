@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef INIT_H
+#define INIT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define INIT_OP_DATA 6 //Longest mail write in any sequence.
+
+//One step of a device init sequence, see init_sequences.hpp. Sequences
+//are plain tables run by GCHD::runInit(), anything that depends on
+//what the device answers stays code.
+enum class InitOpType : uint8_t {
+	MailWrite,   //mailWrite( port, data )
+	MailRead,    //mailRead( port, readSize ), answer not used.
+	Query,       //mailWrite( port, data ), then mailRead( port, readSize ), answer not used.
+	DeviceRead,  //readDevice0x9DCD( data[0] ), answer not used.
+	Enable,      //doEnable( data[0..1], data[2..3] )
+	Poll9989ED,  //pollOn0x9989ED()
+	Read9989EC,  //readFrom0x9989EC( readSize )
+};
+
+struct InitOp {
+	InitOpType type;
+	uint8_t port;
+	uint8_t size; //Bytes of data used.
+	uint8_t readSize; //Bytes read back.
+	uint8_t data[INIT_OP_DATA];
+
+	//Whether this only reads something nobody looks at, and could be
+	//left out if the device doesn't mind.
+	constexpr bool isDiscardedRead() const {
+		return (type == InitOpType::Query) || (type == InitOpType::DeviceRead);
+	}
+};
+
+template<typename... Bytes>
+constexpr InitOp mailWriteOp(uint8_t port, Bytes... bytes) {
+	static_assert(sizeof...(Bytes) <= INIT_OP_DATA, "Mail write too long for InitOp.");
+	return InitOp{InitOpType::MailWrite, port, sizeof...(Bytes), 0, {static_cast<uint8_t>(bytes)...}};
+}
+
+constexpr InitOp mailReadOp(uint8_t port, uint8_t size) {
+	return InitOp{InitOpType::MailRead, port, 0, size, {0}};
+}
+
+template<typename... Bytes>
+constexpr InitOp queryOp(uint8_t port, uint8_t size, Bytes... bytes) {
+	static_assert(sizeof...(Bytes) <= INIT_OP_DATA, "Mail write too long for InitOp.");
+	return InitOp{InitOpType::Query, port, sizeof...(Bytes), size, {static_cast<uint8_t>(bytes)...}};
+}
+
+constexpr InitOp deviceReadOp(uint8_t index) {
+	return InitOp{InitOpType::DeviceRead, 0, 1, 1, {index}};
+}
+
+constexpr InitOp enableOp(uint16_t setMask, uint16_t valueMask) {
+	return InitOp{InitOpType::Enable, 0, 4, 0,
+		{static_cast<uint8_t>(setMask >> 8), static_cast<uint8_t>(setMask & 0xff),
+		 static_cast<uint8_t>(valueMask >> 8), static_cast<uint8_t>(valueMask & 0xff)}};
+}
+
+constexpr InitOp poll9989EDOp() {
+	return InitOp{InitOpType::Poll9989ED, 0, 0, 0, {0}};
+}
+
+constexpr InitOp read9989ECOp(uint8_t count) {
+	return InitOp{InitOpType::Read9989EC, 0, 0, count, {0}};
+}
+
+//Time spent in each sequence, for -init-stats.
+struct InitStats {
+	unsigned long runs;
+	unsigned long ops;
+	unsigned long skipped;
+	double seconds;
+};
+
+#endif
@@ -0,0 +1,756 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef INIT_SEQUENCES_H
+#define INIT_SEQUENCES_H
+
+#include "init.hpp"
+
+//Literal runs of the device init, as captured from the original driver.
+//Each table is run in place of the code it replaced by GCHD::runInit(),
+//named after the function it is run from. Steps depending on settings or
+//on what the device answers are still in configure*.cpp.
+namespace InitSequence {
+
+//From configure.cpp
+constexpr InitOp deviceBlockA[] = {
+	queryOp( 0x33, 1, 0x89, 0x89, 0xfb ), //EXPECTED {0x6e}
+
+	//Potential subroutine
+	mailWriteOp( 0x44, 0x02, 0xc9 ),
+	mailWriteOp( 0x44, 0x14, 0xd2 ),
+	mailWriteOp( 0x44, 0x3c, 0x6b ),
+	queryOp( 0x33, 1, 0x89, 0x89, 0xfa ), //EXPECTED {0xed}
+	queryOp( 0x33, 1, 0x89, 0x89, 0xca ), //EXPECTED {0xee}
+	queryOp( 0x33, 1, 0x89, 0x89, 0xe7 ), //EXPECTED {0x49}
+	mailWriteOp( 0x44, 0x03, 0x2a ),
+	mailWriteOp( 0x44, 0x05, 0x89 ),
+};
+
+constexpr InitOp deviceBlockB[] = {
+	mailWriteOp( 0x44, 0x19, 0xde ),
+	mailWriteOp( 0x44, 0x1a, 0x87 ),
+	mailWriteOp( 0x44, 0x1b, 0x88 ),
+	mailWriteOp( 0x44, 0x29, 0x8b ),
+	mailWriteOp( 0x44, 0x2d, 0x8f ),
+	mailWriteOp( 0x44, 0x4c, 0x89 ),
+	mailWriteOp( 0x44, 0x55, 0x88 ),
+	mailWriteOp( 0x44, 0x6b, 0xae ),
+	mailWriteOp( 0x44, 0x6c, 0xbe ),
+	mailWriteOp( 0x44, 0x6d, 0x78 ),
+	mailWriteOp( 0x44, 0x6e, 0xa0 ),
+	mailWriteOp( 0x44, 0x06, 0x08 ),
+
+	//Potential subroutine
+	mailWriteOp( 0x44, 0x02, 0xc9 ),
+	mailWriteOp( 0x44, 0x14, 0xd2 ),
+	mailWriteOp( 0x44, 0x3c, 0x6b ),
+	queryOp( 0x33, 1, 0x89, 0x89, 0xfa ), //EXPECTED {0xfd}
+	mailWriteOp( 0x44, 0x28, 0x88 ),
+	mailWriteOp( 0x44, 0x10, 0x88 ),
+	mailWriteOp( 0x44, 0x11, 0xd4 ),
+	mailWriteOp( 0x44, 0x12, 0xd0 ),
+	mailWriteOp( 0x44, 0x13, 0x08 ),
+	mailWriteOp( 0x44, 0x14, 0x08 ),
+	mailWriteOp( 0x44, 0x15, 0x88 ),
+	mailWriteOp( 0x33, 0x94, 0x47, 0xf9 ),
+	mailWriteOp( 0x33, 0x94, 0x40, 0xf3 ),
+	mailWriteOp( 0x33, 0x94, 0x43, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x4e, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x4f, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x48, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x49, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x58, 0x77 ),
+	mailWriteOp( 0x33, 0x94, 0x40, 0xf1 ),
+	mailWriteOp( 0x33, 0x94, 0x4d, 0xf5 ),
+	mailWriteOp( 0x33, 0x94, 0x4a, 0xaf ),
+	mailWriteOp( 0x33, 0x94, 0x4b, 0xaf ),
+	mailWriteOp( 0x33, 0x94, 0x5c, 0xb7 ),
+	mailWriteOp( 0x33, 0x94, 0x46, 0xd7 ),
+
+	deviceReadOp( 0x88 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xb7, 0xce ),
+	mailWriteOp( 0x4e, 0x41, 0xa3 ),
+	mailWriteOp( 0x4e, 0xb8, 0xcc ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xcd ),
+	mailWriteOp( 0x4e, 0x0f, 0xce ),
+	mailWriteOp( 0x4e, 0x16, 0xfc ),
+	mailWriteOp( 0x4e, 0x17, 0xcc ),
+	mailWriteOp( 0x4e, 0x18, 0xcc ),
+	mailWriteOp( 0x4e, 0x19, 0xcc ),
+	mailWriteOp( 0x4e, 0x1a, 0x9c ),
+	deviceReadOp( 0x15 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x2a, 0xcb ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb3
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x08, 0xcf ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcd ),
+};
+
+constexpr InitOp deviceBlockC[] = {
+	mailWriteOp( 0x4e, 0x25, 0xcc ),
+	mailWriteOp( 0x4e, 0x30, 0x4c ),
+	mailWriteOp( 0x4e, 0x31, 0xcc ),
+	mailWriteOp( 0x4e, 0x32, 0xcc ),
+	mailWriteOp( 0x4e, 0x25, 0xcc ),
+	mailWriteOp( 0x4e, 0x26, 0xcc ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb3
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0xb0, 0xe8 ),
+	deviceReadOp( 0x91 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xae, 0xc8 ),
+	mailWriteOp( 0x4e, 0xb1, 0x0c ),
+	mailWriteOp( 0x4e, 0xb2, 0xcc ),
+	mailWriteOp( 0x4e, 0xb3, 0xcc ),
+	mailWriteOp( 0x4e, 0xb4, 0x99 ),
+	deviceReadOp( 0x8b ), //EXPECTED 0xe7
+	mailWriteOp( 0x4e, 0xb4, 0x98 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x01, 0xad ),
+	mailWriteOp( 0x4e, 0x02, 0x39 ),
+	deviceReadOp( 0x3c ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x03, 0xce ),
+	mailWriteOp( 0x4e, 0x04, 0xcd ),
+	mailWriteOp( 0x4e, 0x05, 0xcc ),
+	mailWriteOp( 0x4e, 0x06, 0xc4 ),
+	mailWriteOp( 0x4e, 0x1c, 0xd6 ),
+	mailWriteOp( 0x4e, 0x1d, 0xcc ),
+	mailWriteOp( 0x4e, 0x1e, 0xcc ),
+	mailWriteOp( 0x4e, 0x1f, 0xcc ),
+	deviceReadOp( 0x1a ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x25, 0x6e ),
+	deviceReadOp( 0x3d ), //EXPECTED 0x47
+	mailWriteOp( 0x4e, 0x02, 0x39 ),
+	deviceReadOp( 0x38 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x07, 0xc8 ),
+	mailWriteOp( 0x4e, 0x17, 0x0c ),
+	mailWriteOp( 0x4e, 0x19, 0x33 ),
+	mailWriteOp( 0x4e, 0x1a, 0x33 ),
+	mailWriteOp( 0x4e, 0x1b, 0x30 ),
+	mailWriteOp( 0x4e, 0x20, 0xcc ),
+	deviceReadOp( 0x1e ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x21, 0xcc ),
+	mailWriteOp( 0x4e, 0x22, 0xea ),
+	mailWriteOp( 0x4e, 0x27, 0xcc ),
+	deviceReadOp( 0x11 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x2e, 0x6d ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfa ), //EXPECTED {0xa4}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf9 ), //EXPECTED {0x7f}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf8 ), //EXPECTED {0x78}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfe ), //EXPECTED {0x0e}
+	mailWriteOp( 0x4c, 0x05, 0x88 ),
+	mailWriteOp( 0x4c, 0x04, 0xb5 ),
+	mailWriteOp( 0x4c, 0x04, 0x95 ),
+	mailWriteOp( 0x4c, 0x61, 0xb8 ),
+	mailWriteOp( 0x4c, 0x09, 0x3a ),
+	mailWriteOp( 0x4c, 0x0a, 0x70 ),
+	mailWriteOp( 0x4c, 0x0b, 0xbf ),
+	mailWriteOp( 0x4c, 0xc9, 0x88 ),
+	mailWriteOp( 0x4c, 0xca, 0x88 ),
+	mailWriteOp( 0x4c, 0xcb, 0x88 ),
+	mailWriteOp( 0x4c, 0xcc, 0x88 ),
+	mailWriteOp( 0x4c, 0xcd, 0x88 ),
+	mailWriteOp( 0x4c, 0xce, 0x88 ),
+	mailWriteOp( 0x4c, 0xcf, 0x88 ),
+	mailWriteOp( 0x4c, 0xd0, 0x88 ),
+};
+
+constexpr InitOp deviceBlockHDNew[] = {
+	queryOp( 0x33, 1, 0x21, 0x01, 0x72 ), //EXPECTED {0xf4}
+	mailWriteOp( 0x33, 0x20, 0x02, 0x63 ),
+	mailWriteOp( 0x33, 0x20, 0x03, 0x63 ),
+	mailWriteOp( 0x33, 0x20, 0x04, 0x77 ),
+	mailWriteOp( 0x33, 0x20, 0x05, 0x73 ),
+	mailWriteOp( 0x33, 0x20, 0x06, 0x73 ),
+	mailWriteOp( 0x33, 0x20, 0x07, 0x33 ),
+	mailWriteOp( 0x33, 0x20, 0x08, 0x31 ),
+	mailWriteOp( 0x33, 0x20, 0x09, 0x33 ),
+	mailWriteOp( 0x33, 0x20, 0x0a, 0x57 ),
+	mailWriteOp( 0x33, 0x20, 0x0b, 0x7b ),
+	mailWriteOp( 0x33, 0x20, 0x0c, 0xf7 ),
+	mailWriteOp( 0x33, 0x20, 0x0d, 0xf7 ),
+	mailWriteOp( 0x33, 0x20, 0x0e, 0x73 ),
+	mailWriteOp( 0x33, 0x20, 0x0f, 0x73 ),
+};
+
+constexpr InitOp deviceBlockD[] = {
+	mailWriteOp( 0x33, 0xaa, 0x8f, 0x3b ),
+
+	//----------------------------------------------------------
+
+	//The next set of writes and the laster 56 byte reads
+	//are not understood at  all.
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x03, 0x76 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x76 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x73, 0x76 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xab, 0x76 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x76 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x77 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x53, 0x77 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x77 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x77 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xfb, 0x77 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x33, 0x74 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x6b, 0x74 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xa3, 0x74 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xdb, 0x74 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x13, 0x75 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x4b, 0x75 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x83, 0x75 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xbb, 0x75 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xf3, 0x75 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x2b, 0x72 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x63, 0x72 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x9b, 0x72 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xd3, 0x72 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x0b, 0x73 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x43, 0x73 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x7b, 0x73 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xb3, 0x73 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xeb, 0x73 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x23, 0x70 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x5b, 0x70 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x93, 0x70 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xcb, 0x70 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x03, 0x71 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x71 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x73, 0x71 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xab, 0x71 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x71 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x7e ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x53, 0x7e ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x7e ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x7e ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xfb, 0x7e ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x33, 0x7f ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x6b, 0x7f ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xa3, 0x7f ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xdb, 0x7f ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x13, 0x7c ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x4b, 0x7c ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x83, 0x7c ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xbb, 0x7c ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xf3, 0x7c ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x2b, 0x7d ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x63, 0x7d ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x9b, 0x7d ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xd3, 0x7d ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x0b, 0x7a ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x43, 0x7a ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x7b, 0x7a ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xb3, 0x7a ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xeb, 0x7a ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x23, 0x7b ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x5b, 0x7b ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x93, 0x7b ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xcb, 0x7b ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x03, 0x78 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x3b, 0x78 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x73, 0x78 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xab, 0x78 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xe3, 0x78 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x1b, 0x79 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x53, 0x79 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0x8b, 0x79 ),
+	queryOp( 0x33, 56, 0xab, 0x92, 0x3e, 0xb4, 0xc3, 0x79 ),
+	mailWriteOp( 0x33, 0xab, 0xa2, 0x3e, 0xb4, 0xfb, 0x79 ),
+
+	mailReadOp( 0x33, 8 ), //EXPECTED {0xe9, 0x5c, 0xcf, 0x42, 0xb5, 0x28, 0x9b, 0x0e}
+	mailWriteOp( 0x33, 0xaa, 0x8d, 0x35 ),
+};
+
+constexpr InitOp setupSubblock[] = {
+	queryOp( 0x33, 1, 0x99, 0x89, 0x8b ), //EXPECTED {0x6e}
+};
+
+constexpr InitOp setupSubblockHDMI[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc8 ),
+	mailWriteOp( 0x4c, 0x90, 0x88 ),
+	mailWriteOp( 0x4c, 0x91, 0x77 ),
+	mailWriteOp( 0x4c, 0x92, 0x77 ),
+	mailWriteOp( 0x4c, 0x93, 0x77 ),
+	mailWriteOp( 0x4c, 0x94, 0x77 ),
+	mailWriteOp( 0x4c, 0x95, 0x77 ),
+	mailWriteOp( 0x4c, 0x96, 0x77 ),
+	mailWriteOp( 0x4c, 0x97, 0x77 ),
+	mailWriteOp( 0x4c, 0x98, 0x77 ),
+	mailWriteOp( 0x4c, 0x99, 0x77 ),
+	mailWriteOp( 0x4c, 0x9a, 0x77 ),
+	mailWriteOp( 0x4c, 0x9b, 0x77 ),
+	mailWriteOp( 0x4c, 0x9c, 0x77 ),
+	mailWriteOp( 0x4c, 0x9d, 0x77 ),
+	mailWriteOp( 0x4c, 0x9e, 0x77 ),
+	mailWriteOp( 0x4c, 0x9f, 0x77 ),
+	mailWriteOp( 0x4c, 0xa0, 0x77 ),
+	mailWriteOp( 0x4c, 0xa1, 0x77 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	mailWriteOp( 0x4c, 0xa3, 0x77 ),
+};
+
+constexpr InitOp setupSubblock1080i[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0xae ),
+	mailWriteOp( 0x4c, 0x91, 0xc2 ),
+	mailWriteOp( 0x4c, 0x95, 0xde ),
+	mailWriteOp( 0x4c, 0x96, 0x0a ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8a ),
+	mailWriteOp( 0x4c, 0xa1, 0xf8 ),
+	mailWriteOp( 0x4c, 0xa2, 0xbc ),
+	mailWriteOp( 0x4c, 0xa3, 0x1a ),
+};
+
+constexpr InitOp setupSubblock1080p[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0x7e ),
+	mailWriteOp( 0x4c, 0x91, 0x77 ),
+	mailWriteOp( 0x4c, 0x95, 0xde ),
+	mailWriteOp( 0x4c, 0x96, 0x0a ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8c ),
+	mailWriteOp( 0x4c, 0xa1, 0x18 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	mailWriteOp( 0x4c, 0xa3, 0x77 ),
+};
+
+constexpr InitOp setupSubblock720p[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0xfe ),
+	mailWriteOp( 0x4c, 0x91, 0xbb ),
+	mailWriteOp( 0x4c, 0x95, 0xe4 ),
+	mailWriteOp( 0x4c, 0x96, 0x1c ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8d ),
+	mailWriteOp( 0x4c, 0xa1, 0x28 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	mailWriteOp( 0x4c, 0xa3, 0x77 ),
+};
+
+constexpr InitOp setupSubblock576i[] = {
+	mailWriteOp( 0x4c, 0x70, 0xd0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0xd8 ),
+	mailWriteOp( 0x4c, 0x91, 0xbf ),
+	mailWriteOp( 0x4c, 0x95, 0x9d ),
+	mailWriteOp( 0x4c, 0x96, 0x1b ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8a ),
+	mailWriteOp( 0x4c, 0xa1, 0xd8 ),
+	mailWriteOp( 0x4c, 0xa2, 0xb2 ),
+	mailWriteOp( 0x4c, 0xa3, 0x59 ),
+};
+
+constexpr InitOp setupSubblock576p[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0x28 ),
+	mailWriteOp( 0x4c, 0x91, 0x93 ),
+	mailWriteOp( 0x4c, 0x95, 0x82 ),
+	mailWriteOp( 0x4c, 0x96, 0xc2 ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8d ),
+	mailWriteOp( 0x4c, 0xa1, 0x28 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	mailWriteOp( 0x4c, 0xa3, 0x77 ),
+};
+
+constexpr InitOp setupSubblock480i[] = {
+	mailWriteOp( 0x4c, 0x70, 0xd0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0x68 ),
+	mailWriteOp( 0x4c, 0x91, 0xbf ),
+	mailWriteOp( 0x4c, 0x95, 0xab ),
+	mailWriteOp( 0x4c, 0x96, 0x17 ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x8c ),
+	mailWriteOp( 0x4c, 0xa1, 0xf8 ),
+	mailWriteOp( 0x4c, 0xa2, 0x82 ),
+	mailWriteOp( 0x4c, 0xa3, 0x59 ),
+};
+
+constexpr InitOp setupSubblock480p[] = {
+	mailWriteOp( 0x4c, 0x70, 0xc0 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x90, 0x78 ),
+	mailWriteOp( 0x4c, 0x91, 0xb9 ),
+	mailWriteOp( 0x4c, 0x95, 0x86 ),
+	mailWriteOp( 0x4c, 0x96, 0xc4 ),
+	mailWriteOp( 0x4c, 0x97, 0x88 ),
+	mailWriteOp( 0x4c, 0xa0, 0x81 ),
+	mailWriteOp( 0x4c, 0xa1, 0x78 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	mailWriteOp( 0x4c, 0xa3, 0x77 ),
+};
+
+constexpr InitOp commonBlockA[] = {
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfd ), //EXPECTED {0x6e}
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0x88 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0xa8 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0xc8 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x2b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0x6f, 0x73, 0x6e, 0x1c, 0x3f, 0xbe, 0x70, 0x4e, 0x00, 0x46, 0x3b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0x6e, 0x6e, 0x6e, 0x93, 0x6e, 0x5c}
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0xe8 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x52, 0x70, 0x3f, 0x7f, 0x6e, 0x64, 0x4e, 0x4e, 0x4e, 0x4e, 0x4e, 0x4e, 0x6e, 0x6e, 0x6e, 0x92, 0x6e, 0x3d, 0x17, 0x00, 0x0d, 0x23, 0x0f, 0x1d, 0x1a, 0x0b, 0x1c, 0x64, 0x4e, 0x4e, 0x6f, 0xfa}
+
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfd ), //EXPECTED {0x6e}
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0x08 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x6c, 0x6d, 0x72, 0x9f, 0x26, 0xfe, 0x6a, 0x71, 0x6b, 0x7a, 0x7d, 0x6d, 0x7c, 0x4d, 0x67, 0x69, 0x69, 0xed, 0x6f, 0x6e, 0x6e, 0x08, 0x6d, 0x62, 0x6e, 0x7e, 0x6e, 0xee, 0x6f, 0x73, 0xee, 0xbe}
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0x28 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x1c, 0x72, 0x78, 0x4e, 0x7e, 0x42, 0x4b, 0xee, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0xf0, 0x6f, 0x73, 0xee, 0x76, 0x1f, 0x72, 0x78, 0x4e, 0x36, 0x42, 0x4b, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0xf0}
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0x48 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x6f, 0x73, 0x6e, 0xd2, 0x3c, 0xbe, 0x70, 0x4e, 0xd6, 0x46, 0x3b, 0x2e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x70, 0xe2, 0x64, 0xbe, 0xfe, 0x4e, 0x2e, 0x5f, 0x4e, 0x62, 0x2e, 0x3b, 0x6e, 0xce, 0x34}
+	mailWriteOp( 0x4c, 0x15, 0x81 ),
+	mailWriteOp( 0x4c, 0x65, 0x8a ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0x28 ),
+	mailWriteOp( 0x4c, 0x12, 0x68 ),
+	mailWriteOp( 0x4c, 0x13, 0xa8 ),
+	mailWriteOp( 0x4c, 0x14, 0x88 ),
+	mailWriteOp( 0x4c, 0x15, 0x8b ),
+	poll9989EDOp(),
+	read9989ECOp( 32 ), //EXPECTED {0x6e, 0x6e, 0x6e, 0x76, 0xe2, 0x64, 0xbe, 0xe4, 0x4e, 0x8e, 0x43, 0x7e, 0x7e, 0x50, 0xf8, 0x6e, 0xce, 0x34, 0x6e, 0x6e, 0x6e, 0x76, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x6e, 0x28}
+};
+
+constexpr InitOp commonBlockAPost[] = {
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x10, 0x89 ),
+	mailWriteOp( 0x4c, 0x11, 0xfc ),
+	mailWriteOp( 0x4c, 0x12, 0xc8 ),
+	mailWriteOp( 0x4c, 0x13, 0x8b ),
+	mailWriteOp( 0x4c, 0x15, 0x88 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xed ), //EXPECTED {0xec}
+	queryOp( 0x33, 2, 0x99, 0x8a, 0xbf ), //EXPECTED {0x6e, 0xe1}
+};
+
+constexpr InitOp commonBlockB2Middle[] = {
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0xc1, 0x89 ),
+	mailWriteOp( 0x4c, 0xc6, 0x8b ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0x61, 0x88 ),
+
+	mailWriteOp( 0x33, 0x10, 0x00, 0x33 ),
+	mailWriteOp( 0x33, 0x10, 0x01, 0xe3 ),
+	mailWriteOp( 0x33, 0x10, 0x02, 0x71 ),
+	mailWriteOp( 0x33, 0x10, 0x03, 0x72 ),
+	mailWriteOp( 0x33, 0x10, 0x01, 0x63 ),
+	mailWriteOp( 0x4c, 0x0f, 0x89 ),
+};
+
+constexpr InitOp commonBlockB2Tail[] = {
+	mailWriteOp( 0x4c, 0x35, 0x88 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0xc5, 0x88 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xa3 ), //EXPECTED {0x7f}
+	mailWriteOp( 0x4c, 0x58, 0x9d ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xff ), //EXPECTED {0x6b}
+	mailWriteOp( 0x4c, 0x04, 0x8d ),
+	mailWriteOp( 0x4c, 0xe2, 0x6c ),
+	mailWriteOp( 0x4c, 0xe3, 0x88 ),
+	mailWriteOp( 0x4c, 0xe4, 0x80 ),
+	mailWriteOp( 0x4c, 0xe0, 0x49 ),
+	mailWriteOp( 0x4c, 0xe1, 0x89 ),
+	mailWriteOp( 0x4c, 0x0f, 0x89 ),
+	mailWriteOp( 0x4c, 0x91, 0x88 ),
+	mailWriteOp( 0x4c, 0x92, 0x88 ),
+	mailWriteOp( 0x4c, 0x93, 0x89 ),
+	mailWriteOp( 0x4c, 0x94, 0xa9 ),
+	mailWriteOp( 0x4c, 0x95, 0xcb ),
+	mailWriteOp( 0x4c, 0x96, 0xed ),
+	mailWriteOp( 0x4c, 0x97, 0x0f ),
+	mailWriteOp( 0x4c, 0x98, 0x8a ),
+	mailWriteOp( 0x4c, 0x99, 0x53 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xff ), //EXPECTED {0x6b}
+	mailWriteOp( 0x4c, 0x04, 0x8c ),
+	mailWriteOp( 0x4c, 0x0f, 0x89 ),
+	mailWriteOp( 0x4c, 0x68, 0x89 ),
+	mailWriteOp( 0x4c, 0x6b, 0x88 ),
+	mailWriteOp( 0x4c, 0x6c, 0x88 ),
+	mailWriteOp( 0x4c, 0x6d, 0xf8 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0xce, 0x8b ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xff ), //EXPECTED {0x6a}
+	mailWriteOp( 0x4c, 0x04, 0x88 ),
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+	mailWriteOp( 0x4c, 0xc1, 0x88 ),
+	mailWriteOp( 0x4c, 0xc6, 0x8b ),
+};
+
+constexpr InitOp commonBlockB3[] = {
+	mailWriteOp( 0x4c, 0x0f, 0x89 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0x5b ), //EXPECTED {0x7c}
+	queryOp( 0x33, 1, 0x99, 0x89, 0x5a ), //EXPECTED {0x2a}
+	queryOp( 0x33, 1, 0x99, 0x89, 0x59 ), //EXPECTED {0x6c}
+
+	queryOp( 0x33, 1, 0x99, 0x89, 0xc8 ), //EXPECTED {0x6e}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xcf ), //EXPECTED {0x76}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xce ), //EXPECTED {0x6e};
+	mailWriteOp( 0x4c, 0x0f, 0x88 ),
+};
+
+constexpr InitOp commonBlockC[] = {
+	mailWriteOp( 0x33, 0xaa, 0xb8, 0x29, 0xf6 ),
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x73 ), //EXPECTED {0xe6, 0xa6, 0x33, 0xc0, 0x4d, 0xda, 0x67, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x7b ), //EXPECTED {0xf2, 0xb8, 0xcd, 0x3f, 0xb2, 0x25, 0x98, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x63 ), //EXPECTED {0xf7, 0x4e, 0xcd, 0x3c, 0x32, 0x25, 0x9a, 0x73}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x6b ), //EXPECTED {0xfc, 0x96, 0xb8, 0x9c, 0xe5, 0x69, 0x28, 0x28}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x53 ), //EXPECTED {0xef, 0x11, 0x80, 0x3f, 0xb2, 0x25, 0x19, 0xcb}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x5b ), //EXPECTED {0x37, 0x99, 0xcd, 0x3e, 0xb3, 0x24, 0x99, 0x0a}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x43 ), //EXPECTED {0xe7, 0x58, 0xcd, 0x3e, 0xb3, 0x24, 0x9a, 0x31}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x4b ), //EXPECTED {0x66, 0x41, 0xbd, 0x07, 0x9f, 0x65, 0xc0, 0x27}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x33 ), //EXPECTED {0xa3, 0x59, 0x08, 0xb1, 0x93, 0x25, 0x98, 0x15}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x3b ), //EXPECTED {0xe6, 0x59, 0xcc, 0x27, 0xb2, 0x39, 0x8e, 0x2b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x23 ), //EXPECTED {0xbe, 0x75, 0xe9, 0x3f, 0x76, 0xab, 0xb9, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x2b ), //EXPECTED {0xe6, 0xc7, 0xcc, 0x3f, 0xb2, 0xd9, 0x98, 0x4e}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x13 ), //EXPECTED {0x8a, 0x3e, 0xad, 0x4b, 0xdd, 0x2f, 0xb8, 0x2b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x1b ), //EXPECTED {0xc6, 0x79, 0xec, 0x1f, 0xb2, 0x25, 0x98, 0xf6}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x03 ), //EXPECTED {0xe6, 0x4e, 0xf1, 0x26, 0xf4, 0x2a, 0x98, 0x01}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x0b ), //EXPECTED {0xc6, 0x79, 0xec, 0x1f, 0x92, 0x05, 0x99, 0xee}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xf3 ), //EXPECTED {0xe4, 0x5a, 0xea, 0xcb, 0xe3, 0xa0, 0x9c, 0x08}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xfb ), //EXPECTED {0xe4, 0x4b, 0xdf, 0xab, 0xa4, 0x22, 0x9e, 0x1a}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xe3 ), //EXPECTED {0xf3, 0xf8, 0x6e, 0x18, 0xad, 0x35, 0xbb, 0x02}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xeb ), //EXPECTED {0xe1, 0x58, 0x4f, 0x3e, 0xb2, 0x25, 0xff, 0x08}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xd3 ), //EXPECTED {0xea, 0x59, 0xdc, 0x3f, 0x92, 0x08, 0x14, 0x01}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xdb ), //EXPECTED {0x46, 0x4d, 0x9d, 0xcf, 0xa4, 0x25, 0xbe, 0x77}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xc3 ), //EXPECTED {0xa5, 0x59, 0x08, 0xb1, 0x93, 0x25, 0x98, 0x93}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xcb ), //EXPECTED {0x6a, 0x53, 0x1c, 0xb5, 0x92, 0xc5, 0xb5, 0x1b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xb3 ), //EXPECTED {0xf6, 0x67, 0x5a, 0x3f, 0x76, 0xab, 0xb9, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xbb ), //EXPECTED {0xe6, 0x40, 0xcd, 0x22, 0xb2, 0x57, 0xc9, 0xdb}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xa3 ), //EXPECTED {0xf8, 0x79, 0xa2, 0x17, 0xe7, 0x25, 0x5c, 0x85}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0xab ), //EXPECTED {0xc7, 0x59, 0xcc, 0x20, 0xb3, 0x38, 0x18, 0x13}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x93 ), //EXPECTED {0x97, 0x45, 0xda, 0x1f, 0xea, 0x09, 0xbd, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x9b ), //EXPECTED {0x22, 0xd7, 0xed, 0x3f, 0xb2, 0xbb, 0x98, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x83 ), //EXPECTED {0xe6, 0x59, 0xcc, 0x3f, 0xb2, 0x25, 0x98, 0x0b}
+	queryOp( 0x33, 8, 0xa1, 0x08, 0x8b ), //EXPECTED {0xe6, 0x59, 0xcc, 0x3f, 0xb2, 0x25, 0x98, 0x04}
+	mailWriteOp( 0x33, 0xaa, 0xb8, 0x29, 0xe7 ),
+};
+
+//From configure_hdmi.cpp
+constexpr InitOp hdmiBlockA[] = {
+	mailWriteOp( 0x33, 0x94, 0x41, 0x37 ),
+	mailWriteOp( 0x33, 0x94, 0x4a, 0xaf ),
+	mailWriteOp( 0x33, 0x94, 0x4b, 0xaf ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0x94 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xab, 0x4c ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x1b, 0x33 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0x88 ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0xb7, 0xce ),
+	mailWriteOp( 0x4e, 0xb8, 0xdc ),
+	mailWriteOp( 0x4e, 0xb8, 0xcc ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x07, 0x38 ),
+	mailWriteOp( 0x4e, 0x07, 0xc8 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0x51, 0x45 ),
+	deviceReadOp( 0x88 ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0xb7, 0xcc ),
+
+	//Do nothing enable. No idea what it really checks
+	enableOp( 0x0000, 0x0000 ), //state 031e->031e, enable 000a->000a
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	deviceReadOp( 0x3e ), //EXPECTED 0xd3
+	mailWriteOp( 0x4e, 0x01, 0xad ),
+	deviceReadOp( 0x3b ), //EXPECTED 0xb3
+	mailWriteOp( 0x4e, 0x04, 0xcd ),
+	mailWriteOp( 0x4e, 0x06, 0xc4 ),
+	deviceReadOp( 0x36 ), //EXPECTED 0xba
+	mailWriteOp( 0x4e, 0x09, 0xe4 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0x6b ), //EXPECTED 0x82
+	mailWriteOp( 0x4e, 0x54, 0xec ),
+	deviceReadOp( 0x93 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xac, 0x4c ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0x4c ),
+	deviceReadOp( 0x3f ), //EXPECTED 0x32
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0xf1 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xce, 0x4c ),
+	deviceReadOp( 0xf0 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xcf, 0xce ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+};
+
+constexpr InitOp hdmiBlockB[] = {
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x1b, 0x30 ),
+
+	mailWriteOp( 0x4e, 0x1f, 0xdc ),
+	deviceReadOp( 0x29 ), //EXPECTED 0xba
+	mailWriteOp( 0x4e, 0x1f, 0xcc ),
+	deviceReadOp( 0x3b ), //EXPECTED 0xb3
+	mailWriteOp( 0x4e, 0x04, 0xcf ),
+	mailWriteOp( 0x4e, 0x04, 0xcd ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0x40, 0xcc ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xcd ),
+
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0xb0, 0xe8 ),
+	mailWriteOp( 0x4e, 0xb1, 0x0c ),
+	mailWriteOp( 0x4e, 0xad, 0xc9 ),
+	deviceReadOp( 0x8f ), //EXPECTED 0x96
+	mailWriteOp( 0x4e, 0xb0, 0xe9 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0xab, 0xcc ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf5 ), //EXPECTED {0x82}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfd ), //EXPECTED {0x6f}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf5 ), //EXPECTED {0x82}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xfc ), //EXPECTED {0x6e}
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf3 ), //EXPECTED {0x6e}
+	mailWriteOp( 0x4c, 0x0c, 0x89 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0xf5 ), //EXPECTED {0x82}
+	mailWriteOp( 0x4c, 0x0e, 0x65 ),
+	mailWriteOp( 0x4c, 0x0e, 0x64 ),
+};
+
+constexpr InitOp hdmiBlockC[] = {
+	queryOp( 0x33, 1, 0x99, 0x89, 0x6b ), //EXPECTED {0x6e}
+	mailWriteOp( 0x4c, 0xc0, 0x80 ),
+	mailWriteOp( 0x4c, 0xa2, 0x77 ),
+	queryOp( 0x33, 1, 0x99, 0x89, 0x58 ), //EXPECTED {0x91}
+	mailWriteOp( 0x4c, 0xc0, 0x77 ),
+};
+
+//From configure_component.cpp
+constexpr InitOp componentBlockA[] = {
+	mailWriteOp( 0x33, 0x94, 0x41, 0x37 ),
+	mailWriteOp( 0x33, 0x94, 0x4a, 0xaf ),
+	mailWriteOp( 0x33, 0x94, 0x4b, 0xaf ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0x94 ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0xab, 0x4c ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x1b, 0x33 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	deviceReadOp( 0x88 ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0xb7, 0xce ),
+	mailWriteOp( 0x4e, 0xb8, 0xdc ),
+	mailWriteOp( 0x4e, 0xb8, 0xcc ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb2
+	mailWriteOp( 0x4e, 0x00, 0xce ),
+	mailWriteOp( 0x4e, 0x07, 0x38 ),
+	mailWriteOp( 0x4e, 0x07, 0xc8 ),
+	deviceReadOp( 0x3f ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0x00, 0xcc ),
+	mailWriteOp( 0x4e, 0x51, 0xed ), //Changed from HDMI.
+	deviceReadOp( 0x88 ), //EXPECTED 0xb0
+	mailWriteOp( 0x4e, 0xb7, 0xce ), //Changed from HDMI
+
+	//Do nothing enable. No idea what it really checks
+	enableOp( 0x0000, 0x0000 ), //state 031e->031e, enable 000a->000a
+
+	mailWriteOp( 0x4e, 0x24, 0x0c ),
+	mailWriteOp( 0x4e, 0x21, 0xcd ),
+	mailWriteOp( 0x4e, 0x91, 0xc8 ),
+	mailWriteOp( 0x4e, 0x0e, 0x8c ),
+	mailWriteOp( 0x4e, 0x11, 0xec ),
+	mailWriteOp( 0x4e, 0x71, 0x4c ),
+	mailWriteOp( 0x4e, 0x04, 0xcc ), //THIS HAS DIFFERENT VALUE
+};
+
+} //namespace InitSequence
+
+#endif
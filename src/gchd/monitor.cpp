@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include "../gchd.hpp"
+
+//Runs from stream(), so the device is only ever talked to from the
+//thread reading it.
+void GCHD::monitorInput() {
+	InputSource source = currentInputSettings_.getSource();
+	if ((source != InputSource::HDMI) && (source != InputSource::Component)) {
+		return; //Composite has no signal detection.
+	}
+	if (std::chrono::steady_clock::now() < nextMonitor_) {
+		return;
+	}
+
+	if (inputLost_ || inputChanged()) {
+		reconfigureInput();
+	}
+	nextMonitor_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(MONITOR_INTERVAL);
+}
+
+//Same registers configureHDMI() and configureComponent() detect the
+//mode from. One odd reading is not enough, see MONITOR_CONFIRM.
+bool GCHD::inputChanged() {
+	unsigned mode, signal;
+	bool rgbBit = false;
+	bool hdmi = currentInputSettings_.getSource() == InputSource::HDMI;
+
+	if (hdmi) {
+		readHdmiSignalInformation(mode, signal, rgbBit);
+		mailWrite( 0x4e, VC{0x00, 0xcc} ); //Back to the bank configuration left us on.
+	} else {
+		readComponentSignalInformation(mode, signal);
+	}
+
+	bool changed = (std::abs(signal - inputSignal_) >= 10.0) || (std::abs(mode - inputMode_) >= 10.0);
+	//Color space is only followed if it was autodetected in the first place.
+	if (hdmi && (passedInputSettings_.getColorSpace() == ColorSpace::Unknown)) {
+		changed |= rgbBit != (currentInputSettings_.getColorSpace() == ColorSpace::RGB);
+	}
+
+	if (!changed) {
+		inputChanges_ = 0;
+		return false;
+	}
+	return ++inputChanges_ >= MONITOR_CONFIRM;
+}
+
+//Stops the encoder and runs input configuration again, which detects
+//the new mode and sets up the transcoder for it, then restarts. USB,
+//firmware and the outputs are left alone. If there is no usable input,
+//the encoder stays stopped and we try again on the next check.
+void GCHD::reconfigureInput() {
+	if (!inputLost_) {
+		std::cerr << "Input changed, reconfiguring." << std::endl;
+	}
+	auto start = std::chrono::steady_clock::now();
+
+	uint16_t state = read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER) & 0x1f;
+	if ((state == SCMD_STATE_START) || (state == SCMD_STATE_NULL)) {
+		stopStream(true);
+	}
+
+	currentInputSettings_ = passedInputSettings_;
+	currentTranscoderSettings_ = passedTranscoderSettings_;
+	inputChanges_ = 0;
+	try {
+		if (currentInputSettings_.getSource() == InputSource::HDMI) {
+			configureHDMI();
+		} else {
+			configureComponent();
+		}
+	} catch (usb_error &) {
+		throw;
+	} catch (runtime_error &error) {
+		//No signal, or a mode we can't handle.
+		if (!inputLost_) {
+			std::cerr << error.what() << " Waiting for input." << std::endl;
+		}
+		inputLost_ = true;
+		publishSettings();
+		//Device is half configured now, next run must initialize.
+		if (!deviceSettings_.getResumePath().empty()) {
+			std::remove(deviceSettings_.getResumePath().c_str());
+		}
+		return;
+	}
+	inputLost_ = false;
+	restarts_++;
+	publishSettings();
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	std::cerr << "Input reconfigured in "
+		  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+		  << " ms." << std::endl;
+
+	if (!deviceSettings_.getResumePath().empty()) {
+		saveResumeState();
+	}
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <fstream>
+#include <iostream>
+#include "../gchd.hpp"
+
+#define RESUME_MAGIC "GCHDRESUME3"
+
+//What the device was left configured with, see -resume. Written after
+//a full initialization, and only trusted if the device still looks the
+//way it did then.
+void GCHD::saveResumeState() {
+	std::string path = deviceSettings_.getResumePath();
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) {
+		std::cerr << "Can't write resume state to " << path << "." << std::endl;
+		return;
+	}
+
+	std::vector<unsigned char> version;
+	readVersion(version);
+	uint16_t enableState = read_config<uint16_t>(MAIL_SEND_ENABLE_REGISTER_STATE);
+	uint16_t enable = read_config<uint16_t>(ENABLE_REGISTER);
+
+	out << RESUME_MAGIC << std::endl
+	    << (int)deviceType_ << " " << version.data() << std::endl
+	    << enableState << " " << enable << std::endl
+	    << inputSignal_ << " " << inputMode_ << std::endl;
+	passedInputSettings_.save(out);
+	currentInputSettings_.save(out);
+	passedTranscoderSettings_.save(out);
+	currentTranscoderSettings_.save(out);
+}
+
+bool GCHD::resumeConfiguration() {
+	std::ifstream in(deviceSettings_.getResumePath());
+	if (!in) {
+		return false;
+	}
+
+	std::string magic;
+	int deviceType;
+	std::string savedVersion;
+	uint16_t savedEnableState, savedEnable;
+	double inputSignal, inputMode;
+	InputSettings passedInput, currentInput;
+	TranscoderSettings passedTranscoder, currentTranscoder;
+
+	in >> magic >> deviceType >> savedVersion >> savedEnableState >> savedEnable >> inputSignal >> inputMode;
+	if (in.fail() || (magic != RESUME_MAGIC) ||
+	    !passedInput.load(in) || !currentInput.load(in) ||
+	    !passedTranscoder.load(in) || !currentTranscoder.load(in)) {
+		std::cerr << "Resume state is unreadable." << std::endl;
+		return false;
+	}
+
+	if (!(passedInput == passedInputSettings_) || !(passedTranscoder == passedTranscoderSettings_)) {
+		std::cerr << "Settings differ from those the device was configured with." << std::endl;
+		return false;
+	}
+
+	std::vector<unsigned char> version;
+	readVersion(version);
+	if ((deviceType != (int)deviceType_) || (savedVersion != (const char *)version.data())) {
+		std::cerr << "Device is not the one that was configured." << std::endl;
+		return false;
+	}
+
+	//Both firmwares loaded and encoder configured, and nobody has
+	//touched it since.
+	uint16_t state = read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER) & 0x1f;
+	if ((state != SCMD_STATE_STOP) && (state != SCMD_STATE_START) && (state != SCMD_STATE_NULL)) {
+		std::cerr << "Device is not configured." << std::endl;
+		return false;
+	}
+	if ((read_config<uint16_t>(MAIL_SEND_ENABLE_REGISTER_STATE) != savedEnableState) ||
+	    (read_config<uint16_t>(ENABLE_REGISTER) != savedEnable)) {
+		std::cerr << "Device enable state has changed." << std::endl;
+		return false;
+	}
+
+	currentInputSettings_ = currentInput;
+	currentTranscoderSettings_ = currentTranscoder;
+	savedEnableStateRegister_ = savedEnableState;
+	savedEnableRegister_ = savedEnable;
+	inputSignal_ = inputSignal;
+	inputMode_ = inputMode;
+	registerShadow_.invalidate();
+	isInitialized_ = true;
+
+	//Whatever the previous process left in the stream is thrown away,
+	//so output starts cleanly.
+	if (state != SCMD_STATE_STOP) {
+		stopStream(true);
+	}
+	std::cerr << "Device is still configured, skipping initialization." << std::endl;
+	resume();
+	currentInputSettings_.dumpMode();
+	return true;
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <chrono>
+#include <iostream>
+#include "../gchd.hpp"
+
+InputSettings GCHD::getInputSettings() {
+	std::lock_guard<std::mutex> lock(controlMutex_);
+	return publishedInput_;
+}
+
+TranscoderSettings GCHD::getTranscoderSettings() {
+	std::lock_guard<std::mutex> lock(controlMutex_);
+	return publishedTranscoder_;
+}
+
+//A change still on its way counts, or the next one would start from
+//before it and undo it.
+TranscoderSettings GCHD::getRequestedTranscoderSettings() {
+	std::lock_guard<std::mutex> lock(controlMutex_);
+	if (changesApplied_ < changesRequested_) {
+		return pendingTranscoder_;
+	}
+	return publishedRequest_;
+}
+
+uint16_t GCHD::getState() {
+	return state_;
+}
+
+bool GCHD::isInputLost() {
+	return inputLost_;
+}
+
+bool GCHD::changeTranscoderSettings(TranscoderSettings settings, unsigned timeout) {
+	std::unique_lock<std::mutex> lock(controlMutex_);
+	pendingTranscoder_ = settings;
+	unsigned long ticket = ++changesRequested_;
+	changePending_ = true;
+
+	if (!changeApplied_.wait_for(lock, std::chrono::milliseconds(timeout),
+				     [&]() { return changesApplied_ >= ticket; })) {
+		return false;
+	}
+	if (!changeError_.empty()) {
+		throw setting_error(changeError_);
+	}
+	return true;
+}
+
+//The settings we work with are only ever touched by the thread talking
+//to the device, everyone else gets copies.
+void GCHD::publishSettings() {
+	std::lock_guard<std::mutex> lock(controlMutex_);
+	publishedInput_ = currentInputSettings_;
+	publishedTranscoder_ = currentTranscoderSettings_;
+	publishedRequest_ = passedTranscoderSettings_;
+}
+
+//Runs from stream(). Bit rate, GOP and output size are all taken by the
+//encoder between SCMD_STATE_NULL and SCMD_STATE_START. The multiplexer
+//keeps sending meanwhile, so the stream carries on rather than starting
+//over as it does after stopStream().
+void GCHD::applyTranscoderChange() {
+	TranscoderSettings requested;
+	unsigned long ticket;
+	{
+		std::lock_guard<std::mutex> lock(controlMutex_);
+		requested = pendingTranscoder_;
+		ticket = changesRequested_;
+		changePending_ = false;
+	}
+	auto finish = [&](const std::string &error) {
+		std::lock_guard<std::mutex> lock(controlMutex_);
+		changesApplied_ = ticket;
+		changeError_ = error;
+		changeApplied_.notify_all();
+	};
+
+	std::string error;
+	try {
+		if (inputLost_) {
+			//Nothing to encode, used once input is back.
+			passedTranscoderSettings_ = requested;
+		} else {
+			auto start = std::chrono::steady_clock::now();
+			TranscoderSettings current;
+			current.mergeAutodetect(requested, currentInputSettings_);
+
+			uint16_t state = read_config<uint16_t>(SCMD_STATE_READBACK_REGISTER) & 0x1f;
+			if (state == SCMD_STATE_START) {
+				scmd(SCMD_STATE_CHANGE, 0x00, SCMD_STATE_NULL);
+				completeStateChange(SCMD_STATE_START, SCMD_STATE_NULL);
+				transcoderSetup(currentInputSettings_, current);
+				scmd(SCMD_STATE_CHANGE, 0x00, SCMD_STATE_START);
+				completeStateChange(SCMD_STATE_NULL, SCMD_STATE_START);
+			} else {
+				//Stopped, taken up on the next start.
+				transcoderSetup(currentInputSettings_, current);
+			}
+			passedTranscoderSettings_ = requested;
+			currentTranscoderSettings_ = current;
+
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			std::cerr << "Transcoder settings changed in "
+				  << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+				  << " ms." << std::endl;
+		}
+		publishSettings();
+		if (!deviceSettings_.getResumePath().empty() && !inputLost_) {
+			saveResumeState();
+		}
+	} catch (setting_error &settingError) {
+		error = settingError.what();
+	} catch (std::exception &exception) {
+		//Device trouble is up to stream()'s caller, but whoever asked
+		//for the change must not be left waiting on it.
+		finish(exception.what());
+		throw;
+	}
+	finish(error);
+}
@@ -7,9 +7,12 @@
 
 #include "settings.hpp"
 #include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <vector>
+#include "../utility.hpp"
 
 void convertResolution( unsigned &horizontal, unsigned &vertical, const Resolution resolution ) {
 	switch (resolution) {
@@ -354,6 +357,34 @@ void InputSettings::dumpMode() {
 	std::cerr << std::endl;
 }
 
+void InputSettings::save(std::ostream &out) {
+	out << std::setprecision(17)
+	    << (int)source_ << " " << (int)resolution_ << " " << (int)scanMode_ << " "
+	    << refreshRate_ << " " << (int)colorSpace_ << " " << (int)hdmiColorSpace_ << " "
+	    << stretchedSD_ << std::endl;
+}
+
+bool InputSettings::load(std::istream &in) {
+	int source, resolution, scanMode, colorSpace, hdmiColorSpace;
+	in >> source >> resolution >> scanMode >> refreshRate_ >> colorSpace >> hdmiColorSpace >> stretchedSD_;
+	source_=(InputSource)source;
+	resolution_=(Resolution)resolution;
+	scanMode_=(ScanMode)scanMode;
+	colorSpace_=(ColorSpace)colorSpace;
+	hdmiColorSpace_=(HDMIColorSpace)hdmiColorSpace;
+	return !in.fail();
+}
+
+bool InputSettings::operator==(const InputSettings &other) const {
+	return (source_ == other.source_) &&
+	       (resolution_ == other.resolution_) &&
+	       (scanMode_ == other.scanMode_) &&
+	       (refreshRate_ == other.refreshRate_) &&
+	       (colorSpace_ == other.colorSpace_) &&
+	       (hdmiColorSpace_ == other.hdmiColorSpace_) &&
+	       (stretchedSD_ == other.stretchedSD_);
+}
+
 TranscoderSettings::TranscoderSettings() {
 	//These are the options that meet the following criteria:
 	//  1. We understand how they are set and configured
@@ -383,6 +414,7 @@ TranscoderSettings::TranscoderSettings() {
 	effectiveFrameRate_=0.0;
 	h264Profile_=H264Profile::High;
 	h264Level_=0.0; //Auto
+	gopSize_=0; //Auto
 }
 
 void TranscoderSettings::getResolution( unsigned &x, unsigned &y) {
@@ -480,6 +512,82 @@ unsigned TranscoderSettings::getRealMaxBitRateKbps() {
 	}
 }
 
+void TranscoderSettings::parseBitRate( const std::string &value ) {
+	if (value == "auto") {
+		setBitRateMode( BitRateMode::Constant );
+		setConstantBitRateMbps( 0.0 );
+		setVariableBitRateMbps( 0.0, 0.0, 0.0 );
+		return;
+	}
+
+	std::vector<std::string> bitRateParts=Utility::split(value, ':');
+	std::vector<float> bitRateFloatParts;
+
+	for( auto it = bitRateParts.begin(); it != bitRateParts.end(); ++it) {
+		char *endPtr;
+		std::string copy=*it;
+		copy=Utility::trim(copy); //Modifies copy
+
+		float part=strtof( copy.c_str(), &endPtr );
+
+		if( *endPtr != 0 ) {
+			//Wasn't a valid number.
+			throw setting_error( "Could not understand bit rate string: '" + value + "'" );
+		}
+		if( part < 0.0 ) {
+			throw setting_error( "Cannot specify negative number for bit rate: '" + value + "'" );
+		}
+		bitRateFloatParts.push_back( part );
+	}
+	if( bitRateFloatParts.size() == 1 ) {
+		setConstantBitRateMbps( bitRateFloatParts[0] );
+		setBitRateMode( BitRateMode::Constant );
+	} else if( bitRateFloatParts.size() == 3 ) {
+		setVariableBitRateMbps( bitRateFloatParts[0],
+				bitRateFloatParts[1],
+				bitRateFloatParts[2] );
+		setBitRateMode( BitRateMode::Variable );
+	} else {
+		throw setting_error( "Bit rate must be specified as single number, or in form max:average:min" );
+	}
+}
+
+bool TranscoderSettings::parseResolution( const std::string &value ) {
+	if (value == "ntsc") {
+		setResolution(Resolution::NTSC);
+	} else if (value == "480") {
+		setResolution(Resolution::NTSC);
+	} else if (value == "pal") {
+		setResolution(Resolution::PAL);
+	} else if (value == "576") {
+		setResolution(Resolution::PAL);
+	} else if (value == "720") {
+		setResolution(Resolution::HD720);
+	} else if (value == "1080") {
+		setResolution(Resolution::HD1080);
+	} else if (value == "auto") {
+		setResolution(Resolution::Unknown);
+	} else {
+		unsigned long x,y;
+		if( !Utility::parseNumericResolution( x, y, value ) ) {
+			return false;
+		}
+		setResolution(x, y);
+	}
+	return true;
+}
+
+void TranscoderSettings::setGopSize( unsigned frames ) {
+	if (frames > MAXIMUM_GOP_SIZE) {
+		throw setting_error( "GOP size can be at most " + std::to_string(MAXIMUM_GOP_SIZE) + " frames." );
+	}
+	gopSize_=frames;
+}
+
+unsigned TranscoderSettings::getGopSize() {
+	return gopSize_;
+}
+
 void TranscoderSettings::setFrameRate(double frameRate) {
 	if (frameRate > 60.0) {
 		throw( setting_error( "Maximum frame rate supported is 60.0 frames per second." ) );
@@ -672,3 +780,133 @@ void TranscoderSettings::mergeAutodetect( TranscoderSettings &prototype, InputSe
 	}
 }
 
+
+void TranscoderSettings::save(std::ostream &out) {
+	out << std::setprecision(17)
+	    << resolution_[0] << " " << resolution_[1] << " " << (int)bitRateMode_ << " "
+	    << constantBitRate_ << " " << maxVariableBitRate_ << " "
+	    << averageVariableBitRate_ << " " << minVariableBitRate_ << " "
+	    << audioBitRate_ << " " << frameRate_ << " " << effectiveFrameRate_ << " "
+	    << (int)h264Profile_ << " " << h264Level_ << " " << gopSize_ << std::endl;
+}
+
+bool TranscoderSettings::load(std::istream &in) {
+	int bitRateMode, h264Profile;
+	in >> resolution_[0] >> resolution_[1] >> bitRateMode
+	   >> constantBitRate_ >> maxVariableBitRate_
+	   >> averageVariableBitRate_ >> minVariableBitRate_
+	   >> audioBitRate_ >> frameRate_ >> effectiveFrameRate_
+	   >> h264Profile >> h264Level_ >> gopSize_;
+	bitRateMode_=(BitRateMode)bitRateMode;
+	h264Profile_=(H264Profile)h264Profile;
+	return !in.fail();
+}
+
+bool TranscoderSettings::operator==(const TranscoderSettings &other) const {
+	return (resolution_[0] == other.resolution_[0]) &&
+	       (resolution_[1] == other.resolution_[1]) &&
+	       (bitRateMode_ == other.bitRateMode_) &&
+	       (constantBitRate_ == other.constantBitRate_) &&
+	       (maxVariableBitRate_ == other.maxVariableBitRate_) &&
+	       (averageVariableBitRate_ == other.averageVariableBitRate_) &&
+	       (minVariableBitRate_ == other.minVariableBitRate_) &&
+	       (audioBitRate_ == other.audioBitRate_) &&
+	       (frameRate_ == other.frameRate_) &&
+	       (effectiveFrameRate_ == other.effectiveFrameRate_) &&
+	       (h264Profile_ == other.h264Profile_) &&
+	       (h264Level_ == other.h264Level_) &&
+	       (gopSize_ == other.gopSize_);
+}
+
+DeviceSettings::DeviceSettings() {
+	ingestTransfers_=4;
+	adaptiveTransfers_=false;
+	replayTiming_=true;
+	registerCache_=true;
+	fastInit_=false;
+	initStats_=false;
+	monitorInput_=false;
+}
+
+unsigned DeviceSettings::getIngestTransfers() {
+	return ingestTransfers_;
+}
+
+void DeviceSettings::setIngestTransfers(unsigned count) {
+	if (count > MAXIMUM_INGEST_TRANSFERS) {
+		throw setting_error( "At most " + std::to_string(MAXIMUM_INGEST_TRANSFERS) + " USB transfers can be queued." );
+	}
+	ingestTransfers_=count;
+}
+
+bool DeviceSettings::getAdaptiveTransfers() {
+	return adaptiveTransfers_;
+}
+
+void DeviceSettings::setAdaptiveTransfers(bool adaptive) {
+	adaptiveTransfers_=adaptive;
+}
+
+std::string DeviceSettings::getRecordPath() {
+	return recordPath_;
+}
+
+void DeviceSettings::setRecordPath(std::string path) {
+	recordPath_=path;
+}
+
+std::string DeviceSettings::getReplayPath() {
+	return replayPath_;
+}
+
+void DeviceSettings::setReplayPath(std::string path) {
+	replayPath_=path;
+}
+
+bool DeviceSettings::getReplayTiming() {
+	return replayTiming_;
+}
+
+void DeviceSettings::setReplayTiming(bool timing) {
+	replayTiming_=timing;
+}
+
+bool DeviceSettings::getRegisterCache() {
+	return registerCache_;
+}
+
+void DeviceSettings::setRegisterCache(bool cache) {
+	registerCache_=cache;
+}
+
+bool DeviceSettings::getFastInit() {
+	return fastInit_;
+}
+
+void DeviceSettings::setFastInit(bool fast) {
+	fastInit_=fast;
+}
+
+bool DeviceSettings::getInitStats() {
+	return initStats_;
+}
+
+void DeviceSettings::setInitStats(bool stats) {
+	initStats_=stats;
+}
+
+bool DeviceSettings::getMonitorInput() {
+	return monitorInput_;
+}
+
+void DeviceSettings::setMonitorInput(bool monitor) {
+	monitorInput_=monitor;
+}
+
+std::string DeviceSettings::getResumePath() {
+	return resumePath_;
+}
+
+void DeviceSettings::setResumePath(std::string path) {
+	resumePath_=path;
+}
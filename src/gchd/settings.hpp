@@ -8,11 +8,15 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#include <iostream>
 #include <stdexcept>
+#include <string>
 
 #define MAXIMUM_AUDIO_BIT_RATE 576 //Maximum AAC audio bit rate for two channels
 #define MAXIMUM_BIT_RATE 40.0
 #define MINIMUM_BIT_RATE .032 //Woah that is slow.
+#define MAXIMUM_INGEST_TRANSFERS 32
+#define MAXIMUM_GOP_SIZE 255 //v_gop_size is 8 bits.
 
 enum class ColorSpace {
 	Unknown,
@@ -108,6 +112,11 @@ class InputSettings {
 		void checkInputSettingsValidity(bool configured);
 		void dumpMode();
 
+		//For -resume state files.
+		void save(std::ostream &out);
+		bool load(std::istream &in);
+		bool operator==(const InputSettings &other) const;
+
 	private:
 		void checkRefresh( double value, const char *string );
 
@@ -149,6 +158,18 @@ class TranscoderSettings {
 		//Maximum bitrate based on settings, variable or constant.
 		unsigned getRealMaxBitRateKbps();
 
+		//As given to -bit-rate: `auto`, a number in mbps, or
+		//max:average:min for variable bit rate.
+		void parseBitRate( const std::string &value );
+
+		//As given to -output-resolution. Returns false if value is
+		//not understood.
+		bool parseResolution( const std::string &value );
+
+		//Frames between I frames. 0 means auto, based on frame rate.
+		void setGopSize( unsigned frames );
+		unsigned getGopSize();
+
 		void setFrameRate(double frameRate); //0.0 means auto.
 		double getFrameRate();               //0.0 means auto.
 		double getEffectiveFrameRate(); //Refresh rate if frame rate is 0.0
@@ -168,6 +189,11 @@ class TranscoderSettings {
 		static unsigned unsignedH264Level(float value);
 
 		void mergeAutodetect( TranscoderSettings &prototype, InputSettings &currentInput );
+
+		//For -resume state files.
+		void save(std::ostream &out);
+		bool load(std::istream &in);
+		bool operator==(const TranscoderSettings &other) const;
 	private:
 		unsigned resolution_[2];
 		BitRateMode bitRateMode_;
@@ -182,7 +208,70 @@ class TranscoderSettings {
 		double effectiveFrameRate_; //If frameRate_ ends up 0, this will be refresh rate.
 		H264Profile h264Profile_;
 		float h264Level_;
+		unsigned gopSize_;
+
+};
+
+//Settings for how we talk to the device, as opposed to what we ask
+//it to capture or encode.
+class DeviceSettings {
+	public:
+		DeviceSettings();
+
+		//Number of bulk transfers kept queued on the stream endpoint.
+		//0 means plain synchronous reads.
+		unsigned getIngestTransfers();
+		void setIngestTransfers(unsigned count);
 
+		//Tune stream transfer size and timeout to the data rate.
+		bool getAdaptiveTransfers();
+		void setAdaptiveTransfers(bool adaptive);
+
+		//Write a trace of all USB traffic here. Empty means don't.
+		std::string getRecordPath();
+		void setRecordPath(std::string path);
+
+		//Answer from this trace instead of a device. Empty means don't.
+		std::string getReplayPath();
+		void setReplayPath(std::string path);
+
+		//Replay at recorded speed, rather than as fast as possible.
+		bool getReplayTiming();
+		void setReplayTiming(bool timing);
+
+		//Skip transcoder writes that wouldn't change anything.
+		bool getRegisterCache();
+		void setRegisterCache(bool cache);
+
+		//Leave out init reads whose answers are never looked at.
+		bool getFastInit();
+		void setFastInit(bool fast);
+
+		//Print time spent in each init sequence.
+		bool getInitStats();
+		void setInitStats(bool stats);
+
+		//Watch the input while streaming, and reconfigure when it
+		//changes.
+		bool getMonitorInput();
+		void setMonitorInput(bool monitor);
+
+		//Where to keep what the device was configured with, so a
+		//restart can skip initialization. Empty means don't.
+		std::string getResumePath();
+		void setResumePath(std::string path);
+
+	private:
+		unsigned ingestTransfers_;
+		bool adaptiveTransfers_;
+		std::string recordPath_;
+		std::string replayPath_;
+		bool replayTiming_;
+		bool registerCache_;
+		bool fastInit_;
+		bool initStats_;
+		bool monitorInput_;
+		std::string resumePath_;
 };
 
 
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include "shadow.hpp"
+
+RegisterShadow::RegisterShadow() {
+	enabled_ = true;
+	bankKnown_ = false;
+	bank_ = 0;
+	writes_ = 0;
+	elided_ = 0;
+}
+
+bool RegisterShadow::elide(uint16_t address, uint32_t value, uint32_t mask) {
+	if (changed(address, value, mask)) {
+		return false;
+	}
+	elided_++;
+	return true;
+}
+
+uint32_t RegisterShadow::changed(uint16_t address, uint32_t value, uint32_t mask) {
+	if (!enabled_) {
+		return mask;
+	}
+
+	auto it = words_.find(address);
+	if (it == words_.end()) {
+		return mask;
+	}
+	uint32_t same = it->second.known & ~(it->second.value ^ value);
+	return mask & ~same;
+}
+
+void RegisterShadow::update(uint16_t address, uint32_t value, uint32_t mask) {
+	writes_++;
+	if (!enabled_) {
+		return;
+	}
+
+	Word &word = words_[address]; //Starts out all unknown.
+	word.value = (word.value & ~mask) | (value & mask);
+	word.known |= mask;
+}
+
+void RegisterShadow::invalidate() {
+	words_.clear();
+}
+
+void RegisterShadow::invalidate(uint16_t address) {
+	words_.erase(address);
+}
+
+void RegisterShadow::selectBank(uint16_t bank) {
+	if (!bankKnown_ || (bank != bank_)) {
+		invalidate();
+	}
+	bank_ = bank;
+	bankKnown_ = true;
+}
+
+bool RegisterShadow::getEnabled() {
+	return enabled_;
+}
+
+void RegisterShadow::setEnabled(bool enabled) {
+	enabled_ = enabled;
+	invalidate();
+}
+
+unsigned long RegisterShadow::getWrites() {
+	return writes_;
+}
+
+unsigned long RegisterShadow::getElided() {
+	return elided_;
+}
+
+void RegisterShadow::resetCounters() {
+	writes_ = 0;
+	elided_ = 0;
+}
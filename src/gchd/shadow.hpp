@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef SHADOW_H
+#define SHADOW_H
+
+#include <cstdint>
+#include <unordered_map>
+
+//Host side copy of the transcoder parameter words written with sparam
+//and slsi, so writes that would not change anything can be skipped.
+//
+//Only bits we wrote ourselves are known. Everything is forgotten when
+//the transcoder may have lost or reset them: firmware loads, resets, and
+//register bank switches.
+class RegisterShadow {
+	public:
+		RegisterShadow();
+
+		//Whether the bits in mask of the 32 bit word at address
+		//are already known to hold value. Counts the write as elided
+		//if so.
+		bool elide(uint16_t address, uint32_t value, uint32_t mask);
+
+		//Bits in mask not already known to hold value.
+		uint32_t changed(uint16_t address, uint32_t value, uint32_t mask);
+
+		//Call after a write went out successfully.
+		void update(uint16_t address, uint32_t value, uint32_t mask);
+
+		void invalidate();
+		void invalidate(uint16_t address);
+
+		//Forgets everything if bank differs from the last one selected.
+		void selectBank(uint16_t bank);
+
+		bool getEnabled();
+		void setEnabled(bool enabled);
+
+		unsigned long getWrites(); //Writes that went out.
+		unsigned long getElided(); //Writes that didn't have to.
+		void resetCounters();
+
+	private:
+		struct Word {
+			uint32_t value;
+			uint32_t known; //Mask of bits value is valid for.
+		};
+
+		std::unordered_map<uint16_t, Word> words_;
+		bool enabled_;
+		bool bankKnown_;
+		uint16_t bank_;
+
+		unsigned long writes_;
+		unsigned long elided_;
+};
+
+#endif
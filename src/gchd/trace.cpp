@@ -0,0 +1,343 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "../utility.hpp"
+#include "trace.hpp"
+
+#define TRACE_MAGIC		"GCHDTRC1"
+#define TRACE_MAGIC_SIZE	8
+#define RECORD_HEADER_SIZE	28
+#define MAXIMUM_RECORD_DATA	0x100000 //Anything bigger is a corrupt trace.
+#define REPLAY_LOOKAHEAD	256 //Control records searched for a match.
+
+bool TraceRecord::isInput() const {
+	return type & 0x80; //Direction bit, for request type and endpoint alike.
+}
+
+bool TraceRecord::write(std::ostream &output) const {
+	unsigned char header[RECORD_HEADER_SIZE];
+
+	header[0] = static_cast<unsigned char>(kind);
+	header[1] = type;
+	header[2] = request;
+	header[3] = 0;
+	Utility::byteify<uint16_t>(header + 4, value);
+	Utility::byteify<uint16_t>(header + 6, index);
+	Utility::byteify<uint32_t>(header + 8, length);
+	Utility::byteify<uint32_t>(header + 12, static_cast<uint32_t>(result));
+	Utility::byteify<uint32_t>(header + 16, transferred);
+	Utility::byteify<uint32_t>(header + 20, duration);
+	Utility::byteify<uint32_t>(header + 24, static_cast<uint32_t>(data.size()));
+
+	output.write(reinterpret_cast<const char *>(header), sizeof(header));
+	output.write(reinterpret_cast<const char *>(data.data()), data.size());
+	return output.good();
+}
+
+bool TraceRecord::read(std::istream &input) {
+	unsigned char header[RECORD_HEADER_SIZE];
+
+	if (!input.read(reinterpret_cast<char *>(header), sizeof(header))) {
+		return false;
+	}
+	kind = static_cast<char>(header[0]);
+	type = header[1];
+	request = header[2];
+	value = Utility::debyteify<uint16_t>(header + 4);
+	index = Utility::debyteify<uint16_t>(header + 6);
+	length = Utility::debyteify<uint32_t>(header + 8);
+	result = static_cast<int32_t>(Utility::debyteify<uint32_t>(header + 12));
+	transferred = Utility::debyteify<uint32_t>(header + 16);
+	duration = Utility::debyteify<uint32_t>(header + 20);
+
+	uint32_t size = Utility::debyteify<uint32_t>(header + 24);
+	if (size > MAXIMUM_RECORD_DATA) {
+		return false;
+	}
+	data.resize(size);
+	return static_cast<bool>(input.read(reinterpret_cast<char *>(data.data()), size));
+}
+
+RecordingTransport::RecordingTransport(std::unique_ptr<Transport> transport, DeviceType deviceType) {
+	transport_ = std::move(transport);
+	deviceType_ = deviceType;
+}
+
+int RecordingTransport::open(std::string path) {
+	trace_.open(path, std::ios::binary | std::ios::trunc);
+	if (!trace_) {
+		std::cerr << "Unable to open " << path << " for recording." << std::endl;
+		return 1;
+	}
+
+	trace_.write(TRACE_MAGIC, TRACE_MAGIC_SIZE);
+	trace_.put(static_cast<char>(deviceType_));
+	return 0;
+}
+
+int RecordingTransport::claimInterface() {
+	return transport_->claimInterface();
+}
+
+void RecordingTransport::releaseInterface() {
+	transport_->releaseInterface();
+}
+
+int RecordingTransport::controlTransfer(uint8_t requestType, uint8_t bRequest,
+					uint16_t wValue, uint16_t wIndex,
+					unsigned char *data, uint16_t wLength,
+					unsigned timeout) {
+	auto start = std::chrono::steady_clock::now();
+	int result = transport_->controlTransfer(requestType, bRequest, wValue, wIndex,
+						 data, wLength, timeout);
+
+	TraceRecord record;
+	record.kind = 'c';
+	record.type = requestType;
+	record.request = bRequest;
+	record.value = wValue;
+	record.index = wIndex;
+	record.length = wLength;
+	record.result = result;
+	record.transferred = (result > 0) ? result : 0;
+
+	//Writes are kept whole, reads only as far as they got.
+	size_t size = record.isInput() ? record.transferred : wLength;
+	save(record, data, size, start);
+
+	return result;
+}
+
+int RecordingTransport::bulkTransfer(unsigned char endpoint, unsigned char *data,
+				     int length, int *transferred, unsigned timeout) {
+	auto start = std::chrono::steady_clock::now();
+	int result = transport_->bulkTransfer(endpoint, data, length, transferred, timeout);
+
+	TraceRecord record;
+	record.kind = 'b';
+	record.type = endpoint;
+	record.request = 0;
+	record.value = 0;
+	record.index = 0;
+	record.length = length;
+	record.result = result;
+	//Not set if the transfer never got submitted. Timeouts still carry
+	//partial data.
+	record.transferred = ((result < 0) && (result != LIBUSB_ERROR_TIMEOUT)) ? 0 : *transferred;
+
+	//Firmware going out is not ours to redistribute.
+	size_t size = record.isInput() ? record.transferred : 0;
+	save(record, data, size, start);
+
+	return result;
+}
+
+int RecordingTransport::interruptTransfer(unsigned char endpoint, unsigned char *data,
+					  int length, int *transferred, unsigned timeout) {
+	auto start = std::chrono::steady_clock::now();
+	int result = transport_->interruptTransfer(endpoint, data, length, transferred, timeout);
+
+	TraceRecord record;
+	record.kind = 'i';
+	record.type = endpoint;
+	record.request = 0;
+	record.value = 0;
+	record.index = 0;
+	record.length = length;
+	record.result = result;
+	record.transferred = ((result < 0) && (result != LIBUSB_ERROR_TIMEOUT)) ? 0 : *transferred;
+
+	size_t size = record.isInput() ? record.transferred : 0;
+	save(record, data, size, start);
+
+	return result;
+}
+
+void RecordingTransport::save(TraceRecord &record, const unsigned char *data, size_t size,
+				  std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	record.duration = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	record.data.assign(data, data + size);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (trace_.is_open() && !record.write(trace_)) {
+		std::cerr << "Error writing USB trace, recording stopped." << std::endl;
+		trace_.close();
+	}
+}
+
+ReplayTransport::ReplayTransport(bool timing) {
+	timing_ = timing;
+	deviceType_ = DeviceType::Unknown;
+	bulkEnded_ = false;
+	matched_ = 0;
+	skipped_ = 0;
+	unmatched_ = 0;
+}
+
+ReplayTransport::~ReplayTransport() {
+	std::cerr << "Replayed " << matched_ << " control and interrupt transfers, "
+		  << skipped_ << " recorded writes skipped, "
+		  << unmatched_ << " writes not in trace." << std::endl;
+}
+
+int ReplayTransport::open(std::string path) {
+	//Two independent read positions into the same file, so stream data
+	//doesn't have to be buffered up while control traffic is matched.
+	control_.open(path, std::ios::binary);
+	bulk_.open(path, std::ios::binary);
+	if (!control_ || !bulk_) {
+		std::cerr << "Unable to open " << path << " for replay." << std::endl;
+		return 1;
+	}
+
+	char header[TRACE_MAGIC_SIZE + 1];
+	if (!control_.read(header, sizeof(header)) || memcmp(header, TRACE_MAGIC, TRACE_MAGIC_SIZE)) {
+		std::cerr << path << " is not a USB trace." << std::endl;
+		return 1;
+	}
+	bulk_.seekg(sizeof(header));
+	deviceType_ = static_cast<DeviceType>(header[TRACE_MAGIC_SIZE]);
+
+	return 0;
+}
+
+DeviceType ReplayTransport::getDeviceType() {
+	return deviceType_;
+}
+
+int ReplayTransport::claimInterface() {
+	return 0;
+}
+
+void ReplayTransport::releaseInterface() {
+}
+
+int ReplayTransport::controlTransfer(uint8_t requestType, uint8_t bRequest,
+				     uint16_t wValue, uint16_t wIndex,
+				     unsigned char *data, uint16_t wLength,
+				     unsigned timeout) {
+	return replay('c', requestType, bRequest, wValue, wIndex, data, wLength);
+}
+
+int ReplayTransport::bulkTransfer(unsigned char endpoint, unsigned char *data,
+				  int length, int *transferred, unsigned timeout) {
+	*transferred = 0;
+	if (!(endpoint & 0x80)) {
+		*transferred = length; //Firmware, device takes anything.
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(bulkMutex_);
+	TraceRecord record;
+	if (bulkEnded_ || !nextRecord(bulk_, record, true)) {
+		if (!bulkEnded_) {
+			std::cerr << "Replay trace exhausted." << std::endl;
+			bulkEnded_ = true;
+		}
+		return LIBUSB_ERROR_NO_DEVICE;
+	}
+
+	delay(record);
+	*transferred = std::min(length, static_cast<int>(record.data.size()));
+	memcpy(data, record.data.data(), *transferred);
+	return record.result;
+}
+
+int ReplayTransport::interruptTransfer(unsigned char endpoint, unsigned char *data,
+				       int length, int *transferred, unsigned timeout) {
+	int result = replay('i', endpoint, 0, 0, 0, data, static_cast<uint16_t>(length));
+
+	*transferred = std::max(result, 0);
+	return std::min(result, 0);
+}
+
+bool ReplayTransport::needsFirmware() {
+	return false;
+}
+
+int ReplayTransport::replay(char kind, uint8_t type, uint8_t request, uint16_t value,
+			    uint16_t index, unsigned char *data, uint16_t length) {
+	bool input = type & 0x80;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	while (pending_.size() < REPLAY_LOOKAHEAD) {
+		TraceRecord record;
+		if (!nextRecord(control_, record, false)) {
+			break;
+		}
+		pending_.push_back(std::move(record));
+	}
+
+	for (size_t i = 0; i < pending_.size(); ++i) {
+		TraceRecord &record = pending_[i];
+
+		if ((record.kind == kind) && (record.type == type) && (record.request == request)
+				&& (record.value == value) && (record.index == index)) {
+			int result;
+			if (kind == 'i') {
+				result = (record.result < 0) ? record.result : record.transferred;
+			} else {
+				result = record.result;
+			}
+
+			if (input && (result > 0)) {
+				result = std::min(result, static_cast<int>(length));
+				result = std::min(result, static_cast<int>(record.data.size()));
+				memcpy(data, record.data.data(), result);
+			} else if (!input && (record.result == static_cast<int32_t>(record.length))) {
+				result = length;
+			}
+
+			delay(record);
+			skipped_ += i;
+			matched_++;
+			pending_.erase(pending_.begin(), pending_.begin() + i + 1);
+			return result;
+		}
+
+		//Writes may only be matched past other writes, reads could
+		//otherwise pick up stale answers meant for later.
+		if (!input && record.isInput()) {
+			break;
+		}
+	}
+
+	if (!input) {
+		unmatched_++;
+		return length;
+	}
+
+	std::cerr << "Replay diverged from trace at " << (kind == 'c' ? "control" : "interrupt")
+		  << " read 0x" << std::hex << (unsigned)request << " 0x" << value
+		  << " 0x" << index << std::dec << "." << std::endl;
+	return LIBUSB_ERROR_IO;
+}
+
+bool ReplayTransport::nextRecord(std::ifstream &trace, TraceRecord &record, bool bulk) {
+	while (record.read(trace)) {
+		bool isBulk = (record.kind == 'b');
+		if (bulk && isBulk && record.isInput()) {
+			return true;
+		}
+		if (!bulk && !isBulk) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ReplayTransport::delay(const TraceRecord &record) {
+	if (timing_ && record.duration) {
+		std::this_thread::sleep_for(std::chrono::microseconds(record.duration));
+	}
+}
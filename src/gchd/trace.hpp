@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../gchd_hardware.hpp"
+#include "transport.hpp"
+
+//One recorded transfer. Stored big endian, as:
+//
+//  kind, type, request, 0          1 byte each
+//  value, index                    2 bytes each
+//  length, result, transferred     4 bytes each (result is signed)
+//  duration                        4 bytes, microseconds
+//  data size                       4 bytes, followed by data
+//
+//Control transfers keep data sent (OUT) or received (IN). Bulk and
+//interrupt transfers keep data received, bulk OUT data (firmware) is
+//not kept.
+struct TraceRecord {
+	char kind; //'c'ontrol, 'b'ulk, 'i'nterrupt
+	uint8_t type; //Request type for control, endpoint otherwise.
+	uint8_t request;
+	uint16_t value;
+	uint16_t index;
+	uint32_t length;
+	int32_t result;
+	uint32_t transferred;
+	uint32_t duration;
+	std::vector<unsigned char> data;
+
+	bool isInput() const;
+	bool write(std::ostream &output) const;
+	bool read(std::istream &input);
+};
+
+//Passes everything through to another transport, and writes a trace of
+//it that ReplayTransport can play back later.
+class RecordingTransport: public Transport {
+	public:
+		RecordingTransport(std::unique_ptr<Transport> transport, DeviceType deviceType);
+
+		int open(std::string path);
+
+		int claimInterface();
+		void releaseInterface();
+
+		int controlTransfer(uint8_t requestType, uint8_t bRequest,
+				    uint16_t wValue, uint16_t wIndex,
+				    unsigned char *data, uint16_t wLength,
+				    unsigned timeout);
+		int bulkTransfer(unsigned char endpoint, unsigned char *data,
+				 int length, int *transferred, unsigned timeout);
+		int interruptTransfer(unsigned char endpoint, unsigned char *data,
+				      int length, int *transferred, unsigned timeout);
+
+	private:
+		void save(TraceRecord &record, const unsigned char *data, size_t size,
+			  std::chrono::steady_clock::time_point start);
+
+		std::unique_ptr<Transport> transport_;
+		DeviceType deviceType_;
+		std::ofstream trace_;
+		std::mutex mutex_; //Stream may be read on its own thread.
+};
+
+//Answers from a trace written by RecordingTransport, no hardware needed.
+//
+//Bulk reads from the stream endpoint are served in order, independent of
+//control traffic. Control and interrupt transfers are matched against
+//the trace in order, but may skip ahead over recorded writes a newer
+//driver no longer does, and writes that aren't in the trace at all are
+//simply acknowledged. A read that can't be matched means the driver has
+//diverged from the trace, and fails with LIBUSB_ERROR_IO.
+class ReplayTransport: public Transport {
+	public:
+		ReplayTransport(bool timing);
+		~ReplayTransport();
+
+		int open(std::string path);
+		DeviceType getDeviceType();
+
+		int claimInterface();
+		void releaseInterface();
+
+		int controlTransfer(uint8_t requestType, uint8_t bRequest,
+				    uint16_t wValue, uint16_t wIndex,
+				    unsigned char *data, uint16_t wLength,
+				    unsigned timeout);
+		int bulkTransfer(unsigned char endpoint, unsigned char *data,
+				 int length, int *transferred, unsigned timeout);
+		int interruptTransfer(unsigned char endpoint, unsigned char *data,
+				      int length, int *transferred, unsigned timeout);
+
+		bool needsFirmware();
+
+	private:
+		//Finds the next call in the control lookahead, returns number of
+		//bytes "transferred" or libusb error, as the device did.
+		int replay(char kind, uint8_t type, uint8_t request, uint16_t value,
+			   uint16_t index, unsigned char *data, uint16_t length);
+		bool nextRecord(std::ifstream &trace, TraceRecord &record, bool bulk);
+		void delay(const TraceRecord &record);
+
+		bool timing_; //Take as long as the device did.
+		DeviceType deviceType_;
+
+		std::ifstream control_; //Read position for control/interrupt.
+		std::ifstream bulk_; //Read position for stream data.
+		std::deque<TraceRecord> pending_; //Control lookahead.
+		bool bulkEnded_;
+
+		unsigned long matched_;
+		unsigned long skipped_; //Recorded writes we didn't do.
+		unsigned long unmatched_; //Writes we did that weren't recorded.
+		std::mutex mutex_; //Control side.
+		std::mutex bulkMutex_;
+};
+
+#endif
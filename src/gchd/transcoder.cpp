@@ -45,7 +45,8 @@ void GCHD::transcoderWriteVideoAndAudioPids()
 using namespace Transcoder;
 void GCHD::transcoderDefaultsInitialize()
 {
-	write_config<uint16_t>(BANKSEL, 0x0000);
+	selectBank(0x0000);
+	ParameterScope batch(this);
 	sparam( v_vinpelclk, 0 );
 	sparam( tbc_mode, 1 );
 	sparam( stout_mode, 0 );
@@ -284,11 +285,14 @@ void GCHD::transcoderDefaultsInitialize()
 	sparam( e_mpeg_mode, 0 );
 	sparam( e_mpeg_protect, 0 );
 	sparam( ach_sel, 0 );
+	batch.end();
 }
 
 using namespace Transcoder;
 void GCHD::transcoderSetup(InputSettings &inputSettings, TranscoderSettings &settings)
 {
+	ParameterScope batch(this);
+
 	//////////////////
 	//VIDEO SETTINGS//
 	//////////////////
@@ -318,6 +322,9 @@ void GCHD::transcoderSetup(InputSettings &inputSettings, TranscoderSettings &set
 	}
 
 	uint16_t gopGroupSize=(effectiveFrameRate+10)/5 ; //Distance between I frames.
+	if( settings.getGopSize() ) {
+		gopGroupSize=settings.getGopSize();
+	}
 	uint16_t variableLengthCodingMode=0; //Always 0, likely means CAVLC coding.
 	//Probably sets variable length coding mode. Based on encoded format
 	//this probably matches entropy_coding_mode_flag in T-REC-H.264-201003-S
@@ -584,6 +591,7 @@ void GCHD::transcoderSetup(InputSettings &inputSettings, TranscoderSettings &set
 	sparam( v_ts_out2_mode, 0 ); //1 first time through original driver
 	sparam( a_ts_out2_mode, 0 ); //2 first time through original driver
 	sparam( a2_mode, 0 ); //3 first time through original driver
+	batch.end();
 }
 
 using namespace Transcoder;
@@ -595,6 +603,7 @@ void GCHD::transcoderOutputEnable(bool value)
 using namespace Transcoder;
 void GCHD::transcoderFinalConfigure(InputSettings &inputSettings, TranscoderSettings &settings)
 {
+	ParameterScope batch(this);
 	transcoderWriteVideoAndAudioPids();
 	sparam( dma_sel_out, 1 );
 
@@ -704,5 +713,6 @@ void GCHD::transcoderFinalConfigure(InputSettings &inputSettings, TranscoderSett
 	sparam( v_disable_aspect_ratio_info_present_flag_bl, 0 );
 	sparam( v_pic_order_present_flag, 1 );
 	sparam( v_pic_order_present_flag_bl, 1 );
+	batch.end();
 }
 
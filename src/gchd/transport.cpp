@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <iostream>
+
+#include "transport.hpp"
+
+// constants
+#define INTERFACE_NUM		0x00
+#define CONFIGURATION_VALUE	0x01
+
+Transport::~Transport() {
+}
+
+struct libusb_device_handle *Transport::getHandle() {
+	return nullptr;
+}
+
+bool Transport::needsFirmware() {
+	return true;
+}
+
+LibusbTransport::LibusbTransport(struct libusb_device_handle *devh) {
+	devh_ = devh;
+	claimed_ = false;
+}
+
+LibusbTransport::~LibusbTransport() {
+	releaseInterface();
+	libusb_close(devh_);
+}
+
+int LibusbTransport::claimInterface() {
+	if (libusb_kernel_driver_active(devh_, INTERFACE_NUM)) {
+		libusb_detach_kernel_driver(devh_, INTERFACE_NUM);
+	}
+
+	if (libusb_set_configuration(devh_, CONFIGURATION_VALUE)) {
+		if (libusb_set_configuration(devh_, CONFIGURATION_VALUE)) {
+			std::cerr << "Could not set configuration." << std::endl;
+			return 1;
+		}
+	}
+
+	if (libusb_claim_interface(devh_, INTERFACE_NUM)) {
+		std::cerr << "Failed to claim interface." << std::endl;
+		return 1;
+	}
+	claimed_ = true;
+
+	return 0;
+}
+
+void LibusbTransport::releaseInterface() {
+	if (claimed_) {
+		libusb_release_interface(devh_, INTERFACE_NUM);
+		claimed_ = false;
+	}
+}
+
+int LibusbTransport::controlTransfer(uint8_t requestType, uint8_t bRequest,
+				     uint16_t wValue, uint16_t wIndex,
+				     unsigned char *data, uint16_t wLength,
+				     unsigned timeout) {
+	return libusb_control_transfer(devh_, requestType, bRequest, wValue, wIndex,
+				       data, wLength, timeout);
+}
+
+int LibusbTransport::bulkTransfer(unsigned char endpoint, unsigned char *data,
+				  int length, int *transferred, unsigned timeout) {
+	return libusb_bulk_transfer(devh_, endpoint, data, length, transferred, timeout);
+}
+
+int LibusbTransport::interruptTransfer(unsigned char endpoint, unsigned char *data,
+				       int length, int *transferred, unsigned timeout) {
+	return libusb_interrupt_transfer(devh_, endpoint, data, length, transferred, timeout);
+}
+
+struct libusb_device_handle *LibusbTransport::getHandle() {
+	return devh_;
+}
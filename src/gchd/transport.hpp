@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <cstdint>
+
+#include <libusb-1.0/libusb.h>
+
+//Everything GCHD says to the device goes through one of these. Transfer
+//calls take the same arguments, and return the same values, as their
+//libusb_*_transfer counterparts, minus the device handle.
+class Transport {
+	public:
+		virtual ~Transport();
+
+		virtual int claimInterface() = 0;
+		virtual void releaseInterface() = 0;
+
+		virtual int controlTransfer(uint8_t requestType, uint8_t bRequest,
+					    uint16_t wValue, uint16_t wIndex,
+					    unsigned char *data, uint16_t wLength,
+					    unsigned timeout) = 0;
+		virtual int bulkTransfer(unsigned char endpoint, unsigned char *data,
+					 int length, int *transferred, unsigned timeout) = 0;
+		virtual int interruptTransfer(unsigned char endpoint, unsigned char *data,
+					      int length, int *transferred, unsigned timeout) = 0;
+
+		//Handle for asynchronous transfers. nullptr if they aren't
+		//possible, and everything has to go through the calls above.
+		virtual struct libusb_device_handle *getHandle();
+
+		//Whether firmware files are needed to talk to this.
+		virtual bool needsFirmware();
+};
+
+//The real thing.
+class LibusbTransport: public Transport {
+	public:
+		LibusbTransport(struct libusb_device_handle *devh);
+		~LibusbTransport();
+
+		int claimInterface();
+		void releaseInterface();
+
+		int controlTransfer(uint8_t requestType, uint8_t bRequest,
+				    uint16_t wValue, uint16_t wIndex,
+				    unsigned char *data, uint16_t wLength,
+				    unsigned timeout);
+		int bulkTransfer(unsigned char endpoint, unsigned char *data,
+				 int length, int *transferred, unsigned timeout);
+		int interruptTransfer(unsigned char endpoint, unsigned char *data,
+				      int length, int *transferred, unsigned timeout);
+
+		struct libusb_device_handle *getHandle();
+
+	private:
+		struct libusb_device_handle *devh_;
+		bool claimed_;
+};
+
+#endif
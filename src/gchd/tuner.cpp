@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "tuner.hpp"
+
+#define TARGET_FILL_TIME	0.02 //Seconds worth of data per transfer we aim for.
+#define TIMEOUT_MARGIN		1.5  //Full transfers should beat the timeout.
+#define TIMEOUT_HYSTERESIS	0.25 //Ignore timeout changes smaller than this.
+#define WINDOW_TRANSFERS	64
+#define WINDOW_MINIMUM		0.25 //Seconds, shorter windows measure badly.
+#define WINDOW_MAXIMUM		1.0
+
+TransferTuner::TransferTuner(unsigned minimumSize, unsigned maximumSize,
+			     unsigned minimumTimeout, unsigned maximumTimeout) {
+	minimumSize_ = minimumSize;
+	maximumSize_ = std::max(minimumSize, maximumSize);
+	minimumTimeout_ = minimumTimeout;
+	maximumTimeout_ = std::max(minimumTimeout, maximumTimeout);
+
+	//Start out where the fixed values always were.
+	size_ = minimumSize_;
+	timeout_ = minimumTimeout_;
+	rate_ = 0.0;
+
+	windowStart_ = std::chrono::steady_clock::now();
+	windowBytes_ = 0;
+	windowTransfers_ = 0;
+}
+
+bool TransferTuner::record(size_t requested, size_t received) {
+	windowBytes_ += received;
+	windowTransfers_++;
+
+	auto now = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(now - windowStart_).count();
+
+	if (seconds < WINDOW_MINIMUM) {
+		return false;
+	}
+	if ((windowTransfers_ < WINDOW_TRANSFERS) && (seconds < WINDOW_MAXIMUM)) {
+		return false;
+	}
+
+	bool changed = adjust(seconds);
+
+	windowStart_ = now;
+	windowBytes_ = 0;
+	windowTransfers_ = 0;
+
+	return changed;
+}
+
+bool TransferTuner::adjust(double seconds) {
+	rate_ = windowBytes_ / seconds;
+
+	//Sizes stay power of two multiples of the minimum, which also
+	//keeps them from flapping back and forth.
+	unsigned size = minimumSize_;
+	while ((size < rate_ * TARGET_FILL_TIME) && (size * 2 <= maximumSize_)) {
+		size *= 2;
+	}
+
+	//Wait as long as it takes to fill up, rather than waking up for
+	//partial transfers. No data at all means waiting as long as allowed.
+	unsigned timeout = maximumTimeout_;
+	if (rate_ > 0.0) {
+		double fillTime = (size / rate_) * TIMEOUT_MARGIN * 1000.0;
+		timeout = static_cast<unsigned>(std::ceil(std::min(fillTime, (double)maximumTimeout_)));
+		timeout = std::max(timeout, minimumTimeout_);
+	}
+
+	bool changed = false;
+	if (size != size_) {
+		size_ = size;
+		changed = true;
+	}
+	if (std::fabs((double)timeout - timeout_) > timeout_ * TIMEOUT_HYSTERESIS) {
+		timeout_ = timeout;
+		changed = true;
+	}
+	return changed;
+}
+
+unsigned TransferTuner::getTransferSize() {
+	return size_;
+}
+
+unsigned TransferTuner::getTimeout() {
+	return timeout_;
+}
+
+double TransferTuner::getRate() {
+	return rate_;
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+//Picks stream transfer size and timeout from the data rate actually
+//coming off the device.
+//
+//At 40 mbps a fixed 16 KiB transfer completes 300 times a second, while
+//at low SD bit rates almost every transfer times out nearly empty, 20
+//times a second. The tuner aims for transfers that fill up in around
+//TARGET_FILL_TIME, and waits long enough for them to fill, always within
+//the given bounds.
+class TransferTuner {
+	public:
+		TransferTuner(unsigned minimumSize, unsigned maximumSize,
+			      unsigned minimumTimeout, unsigned maximumTimeout);
+
+		//Call for each finished transfer. Returns true when transfer
+		//size or timeout changed as a result.
+		bool record(size_t requested, size_t received);
+
+		unsigned getTransferSize();
+		unsigned getTimeout(); //milliseconds
+		double getRate(); //bytes per second, as of last adjustment
+
+	private:
+		bool adjust(double seconds);
+
+		unsigned minimumSize_;
+		unsigned maximumSize_;
+		unsigned minimumTimeout_;
+		unsigned maximumTimeout_;
+
+		unsigned size_;
+		unsigned timeout_;
+		double rate_;
+
+		std::chrono::steady_clock::time_point windowStart_;
+		uint64_t windowBytes_;
+		unsigned windowTransfers_;
+};
+
+#endif
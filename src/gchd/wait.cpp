@@ -0,0 +1,44 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <thread>
+#include "wait.hpp"
+
+WaitTimer::WaitTimer(WaitStats &stats, unsigned timeout) : stats_(stats) {
+	start_ = std::chrono::steady_clock::now();
+	deadline_ = start_ + std::chrono::milliseconds(timeout);
+	excluded_ = std::chrono::steady_clock::duration::zero();
+	delay_ = 0;
+	polls_ = 1;
+}
+
+WaitTimer::~WaitTimer() {
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_ - excluded_).count();
+	stats_.waits++;
+	stats_.polls += polls_;
+	stats_.seconds += seconds;
+	if (seconds > stats_.longest) {
+		stats_.longest = seconds;
+	}
+}
+
+bool WaitTimer::backoff() {
+	if (std::chrono::steady_clock::now() >= deadline_) {
+		return false;
+	}
+
+	delay_ = delay_ ? std::min(delay_ * 2, (unsigned)WAIT_BACKOFF_MAX) : WAIT_BACKOFF_MIN;
+	std::this_thread::sleep_for(std::chrono::microseconds(delay_));
+	polls_++;
+	return true;
+}
+
+void WaitTimer::exclude(std::chrono::steady_clock::duration time) {
+	deadline_ += time;
+	excluded_ += time;
+}
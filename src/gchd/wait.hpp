@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2016 Scott Dossey <seveirein@yahoo.com>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef WAIT_H
+#define WAIT_H
+
+#include <chrono>
+
+#define WAIT_BACKOFF_MIN	50 // Microseconds slept after the first poll that fails.
+#define WAIT_BACKOFF_MAX	2000 // Sleeps double up to this, in microseconds.
+
+//How often and how long we waited on the device for one kind of thing.
+struct WaitStats {
+	unsigned long waits;
+	unsigned long polls;
+	double seconds;
+	double longest;
+};
+
+//Times one wait, see GCHD::waitFor(). Every poll but the first sleeps
+//a bit longer than the one before, so quick waits stay quick and long
+//ones don't cost a USB round trip per spin.
+class WaitTimer {
+	public:
+		WaitTimer(WaitStats &stats, unsigned timeout); //Milliseconds.
+		~WaitTimer(); //Adds this wait to stats.
+
+		//Call when a poll came back not done. Sleeps, and returns
+		//false if the deadline has passed.
+		bool backoff();
+		//Leaves time spent on something other than polling out:
+		//pushes the deadline back by it and doesn't count it.
+		void exclude(std::chrono::steady_clock::duration time);
+
+	private:
+		WaitStats &stats_;
+		std::chrono::steady_clock::time_point start_;
+		std::chrono::steady_clock::time_point deadline_;
+		std::chrono::steady_clock::duration excluded_;
+		unsigned delay_;
+		unsigned long polls_;
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <hls.hpp>
+
+#define HLS_CLOCK	90000 // PTS ticks a second.
+
+int Hls::enable(std::string directory) {
+	if (!directory.empty() && access(directory.c_str(), W_OK)) {
+		std::cerr << "Can't write to " << directory << ": " << strerror(errno) << "." << std::endl;
+		return 1;
+	}
+	directory_ = directory;
+	targetDuration_ = duration_ + static_cast<unsigned>(std::ceil(MAXIMUM_GOP_SIZE / HLS_FRAME_RATE));
+	enabled_ = true;
+
+	std::cerr << "HLS: " << duration_ << " to " << targetDuration_ << " s segments, keeping " << segments_;
+	if (!directory_.empty()) {
+		std::cerr << ", mirrored to " << directory_;
+	}
+	std::cerr << "." << std::endl;
+	return 0;
+}
+
+void Hls::disable() {
+	if (!enabled_) {
+		return;
+	}
+	enabled_ = false;
+	current_.reset();
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (!directory_.empty()) {
+		for (auto &segment : ring_) {
+			unlink(segmentPath(segment.sequence).c_str());
+		}
+		unlink((directory_ + "/" + HLS_PLAYLIST).c_str());
+	}
+	ring_.clear();
+}
+
+void Hls::output(const Buffer &buffer) {
+	if (!enabled_) {
+		return;
+	}
+
+	for (size_t at = 0; at + TS_PACKET_SIZE <= buffer.size(); at += TS_PACKET_SIZE) {
+		const unsigned char *packet = buffer.data() + at;
+		unsigned pid = Ts::getPid(packet);
+		tables_.update(packet);
+
+		uint64_t pts;
+		if ((pid == TS_VIDEO_PID) && Ts::readPts(packet, pts)) {
+			// B-frames step back a little, a restart or a new session
+			// a lot further
+			uint64_t moved = (pts + TS_PTS_RANGE - lastPts_) % TS_PTS_RANGE;
+			bool jump = current_ && (moved > HLS_JUMP * HLS_CLOCK) &&
+				    (moved < TS_PTS_RANGE - HLS_JUMP * HLS_CLOCK);
+			// B-frames stepping back come out huge, they don't count
+			uint64_t elapsed = (pts + TS_PTS_RANGE - startPts_) % TS_PTS_RANGE;
+			bool full = current_ && (elapsed >= static_cast<uint64_t>(targetDuration_) * HLS_CLOCK) &&
+				    (elapsed < TS_PTS_RANGE / 2);
+
+			if (Ts::isRandomAccess(packet)) {
+				if (!current_) {
+					start(pts, discontinuity_);
+				} else if (jump) {
+					finish(lastPts_);
+					start(pts, true);
+				} else if ((elapsed >= static_cast<uint64_t>(duration_) * HLS_CLOCK) &&
+					   (elapsed < TS_PTS_RANGE / 2)) {
+					finish(pts);
+					start(pts, false);
+				}
+			} else if (jump) {
+				// nothing to start the next segment on until a keyframe
+				finish(lastPts_);
+				current_.reset();
+				discontinuity_ = true;
+			} else if (full) {
+				// no keyframe in time, a frame boundary is the best there is
+				finish(pts);
+				start(pts, false);
+			}
+			lastPts_ = pts;
+		}
+
+		if (current_) {
+			current_->insert(current_->end(), packet, packet + TS_PACKET_SIZE);
+		}
+	}
+}
+
+void Hls::setDuration(unsigned seconds) {
+	duration_ = seconds;
+}
+
+void Hls::setSegments(unsigned count) {
+	segments_ = count;
+}
+
+std::string Hls::getPlaylist() {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return playlist();
+}
+
+Hls::Data Hls::getSegment(uint64_t sequence) {
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (ring_.empty() || (sequence < ring_.front().sequence) || (sequence >= nextSequence_)) {
+		return nullptr;
+	}
+	return ring_[sequence - ring_.front().sequence].data;
+}
+
+void Hls::start(uint64_t pts, bool discontinuity) {
+	size_t size = current_ ? current_->size() : 0;
+	current_ = std::make_shared<std::vector<unsigned char>>();
+	current_->reserve(size + size / 4);
+	tables_.append(*current_);
+	startPts_ = pts;
+	discontinuity_ = discontinuity;
+}
+
+void Hls::finish(uint64_t pts) {
+	double duration = static_cast<double>((pts + TS_PTS_RANGE - startPts_) % TS_PTS_RANGE) / HLS_CLOCK;
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ring_.push_back(Segment{nextSequence_++, duration, discontinuity_, current_});
+	while (ring_.size() > segments_) {
+		if (!directory_.empty()) {
+			unlink(segmentPath(ring_.front().sequence).c_str());
+		}
+		if (ring_.front().discontinuity) {
+			discontinuitySequence_++;
+		}
+		ring_.pop_front();
+	}
+	if (!directory_.empty()) {
+		mirror();
+	}
+}
+
+// playlist goes in last, under a temporary name, so readers never see
+// it half written or pointing at a segment that isn't there yet
+void Hls::mirror() {
+	const Segment &segment = ring_.back();
+	std::ofstream file(segmentPath(segment.sequence), std::ofstream::binary);
+	file.write(reinterpret_cast<const char *>(segment.data->data()),
+		   static_cast<long>(segment.data->size()));
+	file.close();
+
+	std::string path = directory_ + "/" + HLS_PLAYLIST;
+	std::ofstream list(path + ".tmp");
+	list << playlist();
+	list.close();
+
+	if (file.fail() || list.fail() || rename((path + ".tmp").c_str(), path.c_str())) {
+		std::cerr << "HLS: can't write to " << directory_ << "." << std::endl;
+	}
+}
+
+std::string Hls::playlist() {
+	std::ostringstream list;
+	list << "#EXTM3U\n"
+	     << "#EXT-X-VERSION:3\n"
+	     << "#EXT-X-TARGETDURATION:" << targetDuration_ << "\n"
+	     << "#EXT-X-MEDIA-SEQUENCE:" << (ring_.empty() ? nextSequence_ : ring_.front().sequence) << "\n";
+	if (discontinuitySequence_) {
+		list << "#EXT-X-DISCONTINUITY-SEQUENCE:" << discontinuitySequence_ << "\n";
+	}
+	list << std::fixed << std::setprecision(3);
+	for (auto &segment : ring_) {
+		if (segment.discontinuity) {
+			list << "#EXT-X-DISCONTINUITY\n";
+		}
+		list << "#EXTINF:" << segment.duration << ",\n"
+		     << "segment-" << segment.sequence << ".ts\n";
+	}
+	return list.str();
+}
+
+std::string Hls::segmentPath(uint64_t sequence) {
+	return directory_ + "/segment-" + std::to_string(sequence) + ".ts";
+}
+
+Hls::Hls() {
+	enabled_ = false;
+	duration_ = HLS_DURATION;
+	segments_ = HLS_SEGMENTS;
+	discontinuity_ = false;
+	startPts_ = 0;
+	lastPts_ = 0;
+	nextSequence_ = 0;
+	discontinuitySequence_ = 0;
+	targetDuration_ = 0;
+}
+
+Hls::~Hls() {
+	disable();
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef HLS_CLASS_H
+#define HLS_CLASS_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <buffer.hpp>
+#include <gchd/settings.hpp>
+#include <ts.hpp>
+
+#define HLS_DURATION	2 // Default segment length, in s.
+#define HLS_SEGMENTS	6 // Default segments kept.
+#define HLS_JUMP	10 // Video PTS moving further than this, in s, starts a new timeline.
+#define HLS_PLAYLIST	"live.m3u8"
+#define HLS_FRAME_RATE	23.976 // Lowest frame rate GOPs are bounded for, IE film over HDMI.
+
+//HTTP Live Streaming: cuts the stream into segments and keeps a live
+//playlist of the last few.
+//
+//Segments are cut on the video PID, at the first keyframe once a segment
+//is long enough, and timed by video PTS rather than the clock, so every
+//segment starts with something a player can decode. Each one starts with
+//a copy of the latest PAT and PMT, so it can be played on its own.
+//
+//The playlist's target duration must never change, so it is set up
+//front to the segment length plus the longest GOP the encoder makes.
+//Should a segment still reach it without a keyframe, IE at a lower frame
+//rate, it is cut at the next frame anyway.
+//
+//Segments live in memory, for Server to hand out, and can be mirrored to
+//a directory, IE on tmpfs, for any web server to pick up.
+class Hls {
+	public:
+		typedef std::shared_ptr<const std::vector<unsigned char>> Data;
+
+		int enable(std::string directory); //Empty for memory only.
+		void disable();
+		void output(const Buffer &buffer);
+		void setDuration(unsigned seconds);
+		void setSegments(unsigned count);
+		//Safe from any thread.
+		std::string getPlaylist();
+		Data getSegment(uint64_t sequence); //nullptr if it's gone or never was.
+		Hls();
+		~Hls();
+
+	private:
+		struct Segment {
+			uint64_t sequence;
+			double duration; //s
+			bool discontinuity; //Doesn't follow on from the one before.
+			Data data;
+		};
+
+		void start(uint64_t pts, bool discontinuity);
+		void finish(uint64_t pts);
+		void mirror(); //Holding mutex_.
+		std::string playlist(); //Holding mutex_.
+		std::string segmentPath(uint64_t sequence);
+
+		bool enabled_;
+		std::string directory_;
+		unsigned duration_;
+		unsigned segments_;
+
+		//Only used by output().
+		std::shared_ptr<std::vector<unsigned char>> current_;
+		bool discontinuity_; //current_ doesn't follow on from the last segment.
+		uint64_t startPts_;
+		uint64_t lastPts_;
+		TsTables tables_;
+
+		std::mutex mutex_;
+		std::deque<Segment> ring_;
+		uint64_t nextSequence_;
+		unsigned long discontinuitySequence_; //Discontinuities gone from ring_.
+		unsigned targetDuration_; //Fixed by enable(), players rely on it.
+};
+
+#endif
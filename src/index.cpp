@@ -0,0 +1,214 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include <index.hpp>
+#include <ts.hpp>
+
+static void writeNumber(std::vector<unsigned char> &data, uint64_t value) {
+	for (unsigned byte = 0; byte < 8; byte++) {
+		data.push_back(value >> (byte * 8));
+	}
+}
+
+static uint64_t readNumber(const unsigned char *data) {
+	uint64_t value = 0;
+	for (unsigned byte = 0; byte < 8; byte++) {
+		value |= static_cast<uint64_t>(data[byte]) << (byte * 8);
+	}
+	return value;
+}
+
+// Carries on from last, a timestamp that wraps at range, so it keeps going
+// up. Small steps back, IE B-frames, stay steps back.
+static uint64_t unwrap(uint64_t value, uint64_t range, uint64_t last) {
+	if (last == INDEX_UNKNOWN) {
+		return value;
+	}
+	uint64_t unwrapped = last - (last % range) + value;
+	if (unwrapped + range / 2 < last) {
+		unwrapped += range;
+	} else if ((unwrapped > last + range / 2) && (unwrapped >= range)) {
+		unwrapped -= range;
+	}
+	return unwrapped;
+}
+
+int IndexWriter::open(std::string path) {
+	fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+	if (fd_ < 0) {
+		std::cerr << "Can't open " << path << ": " << strerror(errno) << std::endl;
+		return 1;
+	}
+	path_ = path;
+
+	pending_.assign(INDEX_MAGIC, INDEX_MAGIC + INDEX_HEADER_SIZE);
+	pts_ = INDEX_UNKNOWN;
+	dts_ = INDEX_UNKNOWN;
+	pcr_ = INDEX_UNKNOWN;
+	commit();
+
+	std::cerr << "Indexing keyframes to: " << path << std::endl;
+	return 0;
+}
+
+void IndexWriter::close() {
+	if (fd_ != -1) {
+		::close(fd_);
+		fd_ = -1;
+	}
+}
+
+bool IndexWriter::isOpen() {
+	return fd_ != -1;
+}
+
+void IndexWriter::scan(const Buffer &buffer, uint64_t offset) {
+	for (size_t at = 0; at + TS_PACKET_SIZE <= buffer.size(); at += TS_PACKET_SIZE) {
+		const unsigned char *packet = buffer.data() + at;
+
+		uint64_t pcr;
+		if (Ts::readPcr(packet, pcr)) {
+			pcr_ = unwrap(pcr, TS_PCR_RANGE, pcr_);
+		}
+
+		uint64_t pts, dts;
+		if ((Ts::getPid(packet) != TS_VIDEO_PID) || !Ts::readPts(packet, pts, dts)) {
+			continue;
+		}
+		pts_ = unwrap(pts, TS_PTS_RANGE, pts_);
+		dts_ = unwrap(dts, TS_PTS_RANGE, dts_);
+
+		if (Ts::isRandomAccess(packet)) {
+			writeNumber(pending_, offset + at);
+			writeNumber(pending_, pts_);
+			writeNumber(pending_, dts_);
+			writeNumber(pending_, pcr_);
+		}
+	}
+}
+
+bool IndexWriter::isDue() {
+	return std::chrono::steady_clock::now() - lastCommit_ >= std::chrono::milliseconds(INDEX_SYNC);
+}
+
+void IndexWriter::commit() {
+	lastCommit_ = std::chrono::steady_clock::now();
+	if (pending_.empty()) {
+		return;
+	}
+
+	// O_APPEND, and whole entries only
+	ssize_t written = write(fd_, pending_.data(), pending_.size());
+	if ((written != static_cast<ssize_t>(pending_.size())) || fdatasync(fd_)) {
+		std::cerr << "Can't write index " << path_ << ": " << strerror(errno) << std::endl;
+		if (written > 0) {
+			ftruncate(fd_, lseek(fd_, 0, SEEK_END) - written);
+		}
+		return;
+	}
+	pending_.clear();
+}
+
+void IndexWriter::postpone() {
+	lastCommit_ = std::chrono::steady_clock::now();
+}
+
+IndexWriter::IndexWriter() {
+	fd_ = -1;
+	pts_ = INDEX_UNKNOWN;
+	dts_ = INDEX_UNKNOWN;
+	pcr_ = INDEX_UNKNOWN;
+}
+
+IndexWriter::~IndexWriter() {
+	close();
+}
+
+int IndexReader::open(std::string path) {
+	fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd_ < 0) {
+		std::cerr << "Can't open " << path << ": " << strerror(errno) << std::endl;
+		return 1;
+	}
+
+	char magic[INDEX_HEADER_SIZE];
+	struct stat status;
+	if ((pread(fd_, magic, sizeof(magic), 0) != sizeof(magic)) ||
+	    memcmp(magic, INDEX_MAGIC, INDEX_HEADER_SIZE) || fstat(fd_, &status)) {
+		std::cerr << path << " is not a keyframe index." << std::endl;
+		close();
+		return 1;
+	}
+	// a partial entry at the end is one that never got written out
+	size_ = (status.st_size - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+	return 0;
+}
+
+void IndexReader::close() {
+	if (fd_ != -1) {
+		::close(fd_);
+		fd_ = -1;
+	}
+	size_ = 0;
+}
+
+size_t IndexReader::size() {
+	return size_;
+}
+
+bool IndexReader::read(size_t entry, IndexEntry &result) {
+	unsigned char data[INDEX_ENTRY_SIZE];
+	if ((entry >= size_) ||
+	    (pread(fd_, data, sizeof(data), INDEX_HEADER_SIZE + entry * INDEX_ENTRY_SIZE) != sizeof(data))) {
+		return false;
+	}
+	result.offset = readNumber(data);
+	result.pts = readNumber(data + 8);
+	result.dts = readNumber(data + 16);
+	result.pcr = readNumber(data + 24);
+	return true;
+}
+
+bool IndexReader::find(uint64_t pts, IndexEntry &result) {
+	if (!read(0, result)) {
+		return false;
+	}
+
+	// first entry past pts, keyframes go up in PTS
+	size_t low = 0, high = size_;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		IndexEntry entry;
+		if (!read(middle, entry)) {
+			return false;
+		}
+		if (entry.pts <= pts) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return low ? read(low - 1, result) : true;
+}
+
+IndexReader::IndexReader() {
+	fd_ = -1;
+	size_ = 0;
+}
+
+IndexReader::~IndexReader() {
+	close();
+}
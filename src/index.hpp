@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef INDEX_CLASS_H
+#define INDEX_CLASS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <buffer.hpp>
+
+#define INDEX_MAGIC	"GCHDIDX1" // First 8 bytes of every index.
+#define INDEX_HEADER_SIZE	8
+#define INDEX_ENTRY_SIZE	32 // Four little endian 64 bit numbers.
+#define INDEX_UNKNOWN	UINT64_MAX // Timestamp not known.
+#define INDEX_SYNC	1000 // How often entries are written out, in ms.
+#define INDEX_SUFFIX	".idx" // Added to the recording's name.
+
+//One keyframe of a recording. Timestamps don't wrap, they keep counting
+//up from where the recording started.
+struct IndexEntry {
+	uint64_t offset; //Of the packet the keyframe starts in.
+	uint64_t pts; //90 kHz.
+	uint64_t dts; //90 kHz, the same as pts if the PES has no DTS.
+	uint64_t pcr; //27 MHz, the last one before the keyframe.
+};
+
+//Writes the keyframe index of a recording while it's being made.
+//
+//The index is a header and a flat array of fixed size entries, so it
+//can be searched in place. Entries are held back until commit(), which
+//must only be called once the recording has been written and synced up
+//to everything scan() has seen, so the index never gets ahead of the
+//recording. Each commit() appends whole entries and fdatasync()s them, a
+//crash leaves at most a partial entry at the end, which IndexReader
+//ignores. close() drops whatever wasn't committed.
+class IndexWriter {
+	public:
+		int open(std::string path);
+		void close();
+		bool isOpen();
+		//buffer is written to the recording at offset.
+		void scan(const Buffer &buffer, uint64_t offset);
+		bool isDue(); //INDEX_SYNC has passed since the last commit().
+		void commit();
+		void postpone(); //Holds entries back for another INDEX_SYNC.
+		IndexWriter();
+		~IndexWriter();
+
+	private:
+		int fd_;
+		std::string path_;
+		std::vector<unsigned char> pending_;
+		std::chrono::steady_clock::time_point lastCommit_;
+		//Last timestamps seen, unwrapped, INDEX_UNKNOWN before the first.
+		uint64_t pts_;
+		uint64_t dts_;
+		uint64_t pcr_;
+};
+
+//Looks keyframes up in an index, without reading all of it.
+class IndexReader {
+	public:
+		int open(std::string path);
+		void close();
+		size_t size(); //Entries.
+		bool read(size_t entry, IndexEntry &result);
+		//Last keyframe with a PTS no later than pts, or the first one
+		//if there is none. O(log n) reads.
+		bool find(uint64_t pts, IndexEntry &result);
+		IndexReader();
+		~IndexReader();
+
+	private:
+		int fd_;
+		size_t size_;
+};
+
+#endif
@@ -17,6 +17,7 @@
 
 #include <getopt.h>
 
+#include "control.hpp"
 #include "gchd.hpp"
 #include "process.hpp"
 #include "streamer.hpp"
@@ -28,10 +29,13 @@ void help(std::string name, bool full) {
 	std::cerr << "Usage:" << std::endl
 		  << "   " << name << " [options] [<destination>]" << std::endl
 		  << "      For `disk` and `fifo` output formats <destination> is a filename." << std::endl
-		  << "      For the `socket` output format, <destination> is [<ip address>][:<port>]." << std::endl
+		  << "      For the `socket`, `udp` and `rtp` output formats, <destination> is" << std::endl
+		  << "      [<ip address>][:<port>]. For `tcp`, `http` and `hls` it is the same," << std::endl
+		  << "      to listen on." << std::endl
 		  << std::endl
 		  << "      The default for `fifo` is `/tmp/gchd.ts`." << std::endl
-		  << "      The default for `socket` is `0.0.0.0:" << PORT_NUM << "`" << std::endl
+		  << "      The default for `socket`, `udp`, `rtp`, `tcp`, `http` and `hls` is" << std::endl
+		  << "      `0.0.0.0:" << PORT_NUM << "`" << std::endl
 		  << "      There is no default for `disk`, <destination> is required." << std::endl
 		  << std::endl
 		  << "Input Options:" << std::endl
@@ -70,8 +74,15 @@ void help(std::string name, bool full) {
 	std::cerr
 			<< "Output Options:" << std::endl
 			<< "   -of, -output-format <format>" << std::endl
-			<< "      Format is `disk`, `socket, or `fifo`. `disk` is default if a " << std::endl
-			<< "      <destination> file is specified, otherwise the default is `fifo`" << std::endl
+			<< "      Format is `disk`, `socket`, `udp`, `rtp`, `tcp`, `http`, `hls` or `fifo`." << std::endl
+			<< "      `disk` is default if a <destination> file is specified, otherwise the" << std::endl
+			<< "      default is `fifo`." << std::endl
+			<< "      `socket` sends each USB transfer as one UDP datagram. `udp` sends " << SOCKET_PACKETS << std::endl
+			<< "      TS packets a datagram, so nothing gets fragmented, and `rtp` adds an" << std::endl
+			<< "      RTP header so receivers can spot loss and reordering. `tcp` serves the" << std::endl
+			<< "      stream to every client that connects, and `http` as a video/mp2t" << std::endl
+			<< "      response to every client that GETs it. `hls` does what `http` does and" << std::endl
+			<< "      serves HTTP Live Streaming at /" HLS_PLAYLIST " too." << std::endl
 			<< std::endl
 			<< "   -or, -output-resolution <resolution>" << std::endl
 			<< "      Output resolution can be `ntsc`, `pal`, `720`, `1080`, or `auto`." << std::endl
@@ -100,6 +111,129 @@ void help(std::string name, bool full) {
 				<< "   -hl, -h264-level <level>" << std::endl
 				<< "      h.264 level. Level can be `1.0`, `1.1`, `1.2`, `1.3`, `2.0`, `2.1`," << std::endl
 				<< "      `2.2`, `3.0`, `3.1`, `3.2`, `4.0`, `4.1` or `auto` (default)." << std::endl
+				<< std::endl
+				<< "   -gop, -gop-size <frames>" << std::endl
+				<< "      Frames from one I frame to the next, at most " << MAXIMUM_GOP_SIZE << ". `auto` (default)" << std::endl
+				<< "      picks about a fifth of a second's worth." << std::endl
+				<< std::endl
+				<< "   -hls-duration <seconds>" << std::endl
+				<< "      Shortest `hls` segment, 1 to 60, default is " << HLS_DURATION << ". Segments are cut at" << std::endl
+				<< "      the first keyframe after this long, so the GOP size sets how much" << std::endl
+				<< "      longer they get. The playlist promises players they never get" << std::endl
+				<< "      more than " << static_cast<unsigned>(std::ceil(MAXIMUM_GOP_SIZE / HLS_FRAME_RATE))
+				<< " s longer, and they are cut there regardless." << std::endl
+				<< std::endl
+				<< "   -hls-segments <count>" << std::endl
+				<< "      Segments `hls` output keeps and lists in its playlist, 2 to 1000." << std::endl
+				<< "      Default is " << HLS_SEGMENTS << "." << std::endl
+				<< std::endl
+				<< "   -hls-mirror <directory>" << std::endl
+				<< "      Write `hls` segments and the playlist to <directory> as well, IE one on" << std::endl
+				<< "      tmpfs that another web server serves." << std::endl
+				<< std::endl
+				<< "   -idx, -index" << std::endl
+				<< "      For `disk` output, also write where every keyframe is to" << std::endl
+				<< "      <destination>" INDEX_SUFFIX ", for gchd-index to seek with." << std::endl
+				<< std::endl
+				<< "   -mif, -multicast-interface <interface>" << std::endl
+				<< "      For `socket`, `udp` and `rtp` output to a multicast group, IE" << std::endl
+				<< "      239.1.1.1:1234 or [ff15::1]:1234, send on this interface, given by" << std::endl
+				<< "      name or IPv4 address. Default is whatever the routing table says." << std::endl
+				<< std::endl
+				<< "   -mttl, -multicast-ttl <hops>" << std::endl
+				<< "      Routers multicast output may pass, 0 to 255. Default is 1, the local" << std::endl
+				<< "      network only." << std::endl
+				<< std::endl
+				<< "   -nml, -no-multicast-loop" << std::endl
+				<< "      Don't deliver multicast output to listeners on this machine." << std::endl
+				<< std::endl
+				<< "   -pace <delay>" << std::endl
+				<< "      For `udp` and `rtp` output, send packets at the rate the stream's PCR" << std::endl
+				<< "      gives instead of in bursts as they come from USB. <delay> is how many" << std::endl
+				<< "      ms they are held back to even out the bursts, IE 100." << std::endl
+				<< std::endl
+				<< "   -slow-clients <policy>" << std::endl
+				<< "      What `tcp` and `http` output do with clients that can't keep up:" << std::endl
+				<< "      `skip` (default) them ahead to the newest keyframe, or `drop` them." << std::endl
+				<< std::endl
+				<< "   -sn, -strip-null" << std::endl
+				<< "      Leave out the null packets the device pads the stream to a constant" << std::endl
+				<< "      rate with. Saves disk space and network bandwidth, most of all at low" << std::endl
+				<< "      bit rates. The stream is variable rate then." << std::endl
+				<< std::endl;
+
+		std::cerr
+				<< "Device Options:" << std::endl
+				<< "   -ut, -usb-transfers <count>" << std::endl
+				<< "      Number of USB transfers kept queued for the stream, so the device" << std::endl
+				<< "      never waits on us. `0` uses single synchronous reads. Default is 4." << std::endl
+				<< std::endl
+				<< "   -au, -adaptive-usb" << std::endl
+				<< "      Adjust USB transfer size and timeout to the data rate, between " << DATA_BUF << std::endl
+				<< "      and " << MAXIMUM_DATA_BUF << " bytes and " << TIMEOUT << " and " << MAXIMUM_TIMEOUT << " ms. Saves wakeups at low bit rates," << std::endl
+				<< "      and per transfer overhead at high ones." << std::endl
+				<< std::endl
+				<< "   -rb, -ring-buffers <count>" << std::endl
+				<< "      Number of transfer sized buffers held between the USB reader and" << std::endl
+				<< "      the output, if the output stalls for longer data is dropped. Default" << std::endl
+				<< "      is " << RING_SIZE << "." << std::endl
+				<< std::endl
+				<< "   -lm, -lock-memory" << std::endl
+				<< "      Lock capture buffers in RAM, so they never get paged out during long" << std::endl
+				<< "      recordings. May need root or a higher `ulimit -l`." << std::endl
+				<< std::endl
+				<< "   -nrc, -no-register-cache" << std::endl
+				<< "      Send every transcoder setting to the device, even those it is known" << std::endl
+				<< "      to have already." << std::endl
+				<< std::endl
+				<< "   -fi, -fast-init" << std::endl
+				<< "      Leave out reads during device initialization whose answers are never" << std::endl
+				<< "      used. Faster, but the device may not like it." << std::endl
+				<< std::endl
+				<< "   -init-stats" << std::endl
+				<< "      Print how long each part of device initialization took, and how" << std::endl
+				<< "      often and long it waited on the device." << std::endl
+				<< std::endl
+				<< "   -mi, -monitor-input" << std::endl
+				<< "      Check the input every second while streaming. If it changes mode" << std::endl
+				<< "      or goes away, the encoder is reconfigured and restarted without" << std::endl
+				<< "      interrupting the output stream. HDMI and Component only." << std::endl
+				<< std::endl
+				<< "   -record <trace>" << std::endl
+				<< "      Write all USB traffic with the device to <trace>, for use with -replay." << std::endl
+				<< std::endl
+				<< "   -replay <trace>" << std::endl
+				<< "      Play back a trace written by -record instead of using a device. No" << std::endl
+				<< "      device or firmware files needed, for testing and benchmarking." << std::endl
+				<< std::endl
+				<< "   -replay-fast" << std::endl
+				<< "      Replay as fast as possible, rather than at recorded speed." << std::endl
+				<< std::endl
+				<< "   -resume <state>" << std::endl
+				<< "      Skip device initialization if the device is still configured as" << std::endl
+				<< "      recorded in <state>, with the same settings. <state> is written after" << std::endl
+				<< "      each full initialization, and the device is left configured on exit." << std::endl
+				<< std::endl
+				<< "   -daemon" << std::endl
+				<< "      Keep running with the device initialized between readers of the" << std::endl
+				<< "      `fifo` output. Each reader only starts and stops the encoder, so" << std::endl
+				<< "      streaming starts in a fraction of a second. Input settings are those" << std::endl
+				<< "      detected at startup, unless -monitor-input is given." << std::endl
+				<< std::endl
+				<< "   -control <socket>" << std::endl
+				<< "      Listen on UNIX socket <socket> for requests to look at the state of" << std::endl
+				<< "      the device, and to change bit rate, GOP size and output resolution" << std::endl
+				<< "      while streaming. One request per line, IE `set bit-rate 8`, see" << std::endl
+				<< "      src/control.hpp." << std::endl
+				<< std::endl
+				<< "   -dvr <size>" << std::endl
+				<< "      Keep the last <size> MiB of the stream, whatever the output, so any" << std::endl
+				<< "      part of it can be saved after the fact with the control socket's" << std::endl
+				<< "      `clip <from> <to> <file>`, in seconds ago, IE `clip 120 0 replay.ts`." << std::endl
+				<< std::endl
+				<< "   -dvr-file <file>" << std::endl
+				<< "      Keep -dvr's buffer in <file>, which is set to its size up front," << std::endl
+				<< "      rather than in memory." << std::endl
 				<< std::endl;
 	}
 	std::cerr
@@ -148,30 +282,6 @@ void version(std::string name, std::string version) {
 	std::cerr << name << " " << version << std::endl;
 }
 
-bool parseNumericResolution( unsigned long &x, unsigned long &y, const std::string input ) {
-	std::vector<std::string> splitValues=Utility::split(input,'x');
-	std::vector<unsigned long> numbers=std::vector<unsigned long>();
-
-	for( auto it = splitValues.begin(); it != splitValues.end(); ++it) {
-		char *endPtr;
-		std::string copy=*it;
-		copy=Utility::trim(copy); //Modifies copy
-
-		long value=strtoul( copy.c_str(), &endPtr, 10);
-
-		if( *endPtr != 0 ) {
-			return false;
-		}
-		numbers.push_back(value);
-	}
-	if( numbers.size() != 2 ) {
-		return false;
-	}
-	x=numbers[0];
-	y=numbers[1];
-	return true;
-}
-
 enum class Args:int {
 	INPUT_SOURCE=1,
 	COLOR_SPACE,
@@ -193,6 +303,33 @@ enum class Args:int {
 	AUDIO_BIT_RATE,
 	H264_PROFILE,
 	H264_LEVEL,
+	GOP_SIZE,
+	STRIP_NULL,
+	PACE,
+	SLOW_CLIENTS,
+	HLS_DURATION_SECONDS,
+	HLS_SEGMENT_COUNT,
+	HLS_MIRROR,
+	INDEX,
+	DVR,
+	DVR_FILE,
+	MULTICAST_INTERFACE,
+	MULTICAST_TTL,
+	NO_MULTICAST_LOOP,
+	USB_TRANSFERS,
+	ADAPTIVE_USB,
+	RING_BUFFERS,
+	LOCK_MEMORY,
+	NO_REGISTER_CACHE,
+	FAST_INIT,
+	INIT_STATS,
+	MONITOR_INPUT,
+	RECORD,
+	REPLAY,
+	REPLAY_FAST,
+	DAEMON,
+	RESUME,
+	CONTROL,
 	HELP,
 	FULL_HELP,
 	VERSION,
@@ -209,6 +346,7 @@ int main(int argc, char *argv[]) {
 	// objects for storing device settings
 	InputSettings inputSettings=InputSettings();
 	TranscoderSettings transcoderSettings=TranscoderSettings();
+	DeviceSettings deviceSettings=DeviceSettings();
 
 	// commandline-specific settings
 	std::string ip;
@@ -220,6 +358,24 @@ int main(int argc, char *argv[]) {
 	std::string output = "/tmp/gchd.ts";
 	int outputSetIndex=0;
 
+	unsigned ringSize=RING_SIZE;
+	bool lockMemory=false;
+	bool stripNull=false;
+	bool index=false;
+	unsigned paceDelay=0;
+	ServerPolicy slowClients=ServerPolicy::Skip;
+	unsigned hlsDuration=HLS_DURATION;
+	unsigned hlsSegments=HLS_SEGMENTS;
+	std::string hlsMirror;
+	std::string multicastInterface;
+	int multicastTtl=-1;
+	bool multicastLoop=true;
+	bool multicastSet=false;
+	bool daemon=false;
+	std::string controlPath;
+	unsigned long dvrSize=0;
+	std::string dvrFile;
+
 	bool destinationSet=false;
 	bool outputFormatSet=false;
 
@@ -230,7 +386,12 @@ int main(int argc, char *argv[]) {
 	enum class Format {
 		Disk,
 		FIFO,
-		Socket
+		Socket,
+		Udp,
+		Rtp,
+		Tcp,
+		Http,
+		Hls
 	} format = Format::FIFO;
 
 	// handling command-line options
@@ -283,6 +444,46 @@ int main(int argc, char *argv[]) {
 	{"h264-profile", required_argument, NULL, (int)Args::H264_PROFILE},
 	{"hl", required_argument, NULL, (int)Args::H264_LEVEL},
 	{"h264-level", required_argument, NULL, (int)Args::H264_LEVEL},
+	{"gop", required_argument, NULL, (int)Args::GOP_SIZE},
+	{"gop-size", required_argument, NULL, (int)Args::GOP_SIZE},
+	{"sn", no_argument, NULL, (int)Args::STRIP_NULL},
+	{"strip-null", no_argument, NULL, (int)Args::STRIP_NULL},
+	{"pace", required_argument, NULL, (int)Args::PACE},
+	{"slow-clients", required_argument, NULL, (int)Args::SLOW_CLIENTS},
+	{"hls-duration", required_argument, NULL, (int)Args::HLS_DURATION_SECONDS},
+	{"hls-segments", required_argument, NULL, (int)Args::HLS_SEGMENT_COUNT},
+	{"hls-mirror", required_argument, NULL, (int)Args::HLS_MIRROR},
+	{"idx", no_argument, NULL, (int)Args::INDEX},
+	{"index", no_argument, NULL, (int)Args::INDEX},
+	{"mif", required_argument, NULL, (int)Args::MULTICAST_INTERFACE},
+	{"multicast-interface", required_argument, NULL, (int)Args::MULTICAST_INTERFACE},
+	{"mttl", required_argument, NULL, (int)Args::MULTICAST_TTL},
+	{"multicast-ttl", required_argument, NULL, (int)Args::MULTICAST_TTL},
+	{"nml", no_argument, NULL, (int)Args::NO_MULTICAST_LOOP},
+	{"no-multicast-loop", no_argument, NULL, (int)Args::NO_MULTICAST_LOOP},
+	{"ut", required_argument, NULL, (int)Args::USB_TRANSFERS},
+	{"usb-transfers", required_argument, NULL, (int)Args::USB_TRANSFERS},
+	{"au", no_argument, NULL, (int)Args::ADAPTIVE_USB},
+	{"adaptive-usb", no_argument, NULL, (int)Args::ADAPTIVE_USB},
+	{"rb", required_argument, NULL, (int)Args::RING_BUFFERS},
+	{"ring-buffers", required_argument, NULL, (int)Args::RING_BUFFERS},
+	{"lm", no_argument, NULL, (int)Args::LOCK_MEMORY},
+	{"lock-memory", no_argument, NULL, (int)Args::LOCK_MEMORY},
+	{"nrc", no_argument, NULL, (int)Args::NO_REGISTER_CACHE},
+	{"no-register-cache", no_argument, NULL, (int)Args::NO_REGISTER_CACHE},
+	{"fi", no_argument, NULL, (int)Args::FAST_INIT},
+	{"fast-init", no_argument, NULL, (int)Args::FAST_INIT},
+	{"init-stats", no_argument, NULL, (int)Args::INIT_STATS},
+	{"mi", no_argument, NULL, (int)Args::MONITOR_INPUT},
+	{"monitor-input", no_argument, NULL, (int)Args::MONITOR_INPUT},
+	{"record", required_argument, NULL, (int)Args::RECORD},
+	{"replay", required_argument, NULL, (int)Args::REPLAY},
+	{"replay-fast", no_argument, NULL, (int)Args::REPLAY_FAST},
+	{"daemon", no_argument, NULL, (int)Args::DAEMON},
+	{"resume", required_argument, NULL, (int)Args::RESUME},
+	{"control", required_argument, NULL, (int)Args::CONTROL},
+	{"dvr", required_argument, NULL, (int)Args::DVR},
+	{"dvr-file", required_argument, NULL, (int)Args::DVR_FILE},
 	{"h", no_argument, NULL, (int)Args::HELP},
 	{"?", no_argument, NULL, (int)Args::HELP},
 	{"help", no_argument, NULL, (int)Args::HELP},
@@ -374,7 +575,7 @@ int main(int argc, char *argv[]) {
 						inputSettings.setResolution(Resolution::Unknown);
 					} else {
 						unsigned long x,y;
-						bool valid=parseNumericResolution( x, y, std::string(optarg) );
+						bool valid=Utility::parseNumericResolution( x, y, std::string(optarg) );
 						if( valid ) {
 							Resolution grabResolution;
 							try {
@@ -436,8 +637,18 @@ int main(int argc, char *argv[]) {
 						format = Format::FIFO;
 					} else if (std::string(optarg) == "socket") {
 						format = Format::Socket;
+					} else if (std::string(optarg) == "udp") {
+						format = Format::Udp;
+					} else if (std::string(optarg) == "rtp") {
+						format = Format::Rtp;
+					} else if (std::string(optarg) == "tcp") {
+						format = Format::Tcp;
+					} else if (std::string(optarg) == "http") {
+						format = Format::Http;
+					} else if (std::string(optarg) == "hls") {
+						format = Format::Hls;
 					} else {
-						const std::vector<std::string> arguments = {"disk", "fifo", "socket"};
+						const std::vector<std::string> arguments = {"disk", "fifo", "socket", "udp", "rtp", "tcp", "http", "hls"};
 						parameter_unknown(process.getName(), argv[currentOptionIndex], arguments);
 						return EXIT_FAILURE;
 					}
@@ -460,30 +671,10 @@ int main(int argc, char *argv[]) {
 					break;
 				}
 				case Args::OUTPUT_RESOLUTION: {
-					if (std::string(optarg) == "ntsc") {
-						transcoderSettings.setResolution(Resolution::NTSC);
-					} else if (std::string(optarg) == "480") {
-						transcoderSettings.setResolution(Resolution::NTSC);
-					} else if (std::string(optarg) == "pal") {
-						transcoderSettings.setResolution(Resolution::PAL);
-					} else if (std::string(optarg) == "576") {
-						transcoderSettings.setResolution(Resolution::PAL);
-					} else if (std::string(optarg) == "720") {
-						transcoderSettings.setResolution(Resolution::HD720);
-					} else if (std::string(optarg) == "1080") {
-						transcoderSettings.setResolution(Resolution::HD1080);
-					} else if (std::string(optarg) == "auto") {
-						transcoderSettings.setResolution(Resolution::Unknown);
-					} else {
-						unsigned long x,y;
-						bool valid=parseNumericResolution( x, y, std::string(optarg) );
-						if( valid ) {
-							transcoderSettings.setResolution(x, y);
-						} else {
-							const std::vector<std::string> arguments = {"ntsc", "pal", "720", "1080", "auto"};
-							parameter_unknown(process.getName(), argv[currentOptionIndex], arguments);
-							return EXIT_FAILURE;
-						}
+					if (!transcoderSettings.parseResolution(optarg)) {
+						const std::vector<std::string> arguments = {"ntsc", "pal", "720", "1080", "auto"};
+						parameter_unknown(process.getName(), argv[currentOptionIndex], arguments);
+						return EXIT_FAILURE;
 					}
 					break;
 				}
@@ -512,47 +703,7 @@ int main(int argc, char *argv[]) {
 					break;
 				}
 				case Args::BIT_RATE: {
-					if (std::string(optarg) == "auto") {
-						transcoderSettings.setBitRateMode( BitRateMode::Constant );
-						transcoderSettings.setConstantBitRateMbps( 0.0 );
-						transcoderSettings.setVariableBitRateMbps( 0.0, 0.0, 0.0 );
-					} else {
-						std::vector<std::string> bitRateParts=Utility::split(optarg, ':');
-						std::vector<float> bitRateFloatParts;
-
-						for( auto it = bitRateParts.begin(); it != bitRateParts.end(); ++it) {
-							char *endPtr;
-							std::string copy=*it;
-							copy=Utility::trim(copy); //Modifies copy
-
-							float value=strtof( copy.c_str(), &endPtr );
-
-							if( *endPtr != 0 ) {
-								//Wasn't a valid number.
-								std::cerr << "Could not understand bit rate string: '" << optarg << "'" << std::endl;
-								return EXIT_FAILURE;
-							}
-							if( value < 0.0 ) {
-								std::cerr << "Cannot specify negative number for bit rate: '" << optarg << "'" << std::endl;
-								return EXIT_FAILURE;
-							}
-							bitRateFloatParts.push_back( value );
-						}
-						if( bitRateFloatParts.size() == 1 ) {
-							transcoderSettings.setConstantBitRateMbps( bitRateFloatParts[0] );
-							transcoderSettings.setBitRateMode( BitRateMode::Constant );
-							//Let the validity checker find any more errors.
-						} else if( bitRateFloatParts.size() == 3 ) {
-							transcoderSettings.setVariableBitRateMbps( bitRateFloatParts[0],
-									bitRateFloatParts[1],
-									bitRateFloatParts[2] );
-							transcoderSettings.setBitRateMode( BitRateMode::Variable );
-							//Let the validity checker find any more errors.
-						} else {
-							std::cerr << "Bit rate must be specified as single number, or in form max:average:min" << std::endl;
-							return EXIT_FAILURE;
-						}
-					}
+					transcoderSettings.parseBitRate(optarg);
 					break;
 				}
 				case Args::AUDIO_BIT_RATE: {
@@ -607,6 +758,177 @@ int main(int argc, char *argv[]) {
 					}
 					break;
 				}
+				case Args::GOP_SIZE: {
+					if (std::string(optarg) == "auto") {
+						transcoderSettings.setGopSize( 0 );
+					} else {
+						char *end;
+						unsigned long value=strtoul(optarg, &end, 10);
+						if(( *end != 0 ) || ( optarg[0] == '-' )) {
+							parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number of frames or `auto`.");
+							return EXIT_FAILURE;
+						}
+						transcoderSettings.setGopSize( value );
+					}
+					break;
+				}
+				case Args::STRIP_NULL: {
+					stripNull=true;
+					break;
+				}
+				case Args::PACE: {
+					char *end;
+					long value=strtol(optarg, &end, 10);
+					if( (*end != 0) || (value <= 0) || (value > 10000) ) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number of ms from 1 to 10000.");
+						return EXIT_FAILURE;
+					}
+					paceDelay=value;
+					break;
+				}
+				case Args::SLOW_CLIENTS: {
+					if (std::string(optarg) == "skip") {
+						slowClients = ServerPolicy::Skip;
+					} else if (std::string(optarg) == "drop") {
+						slowClients = ServerPolicy::Drop;
+					} else {
+						const std::vector<std::string> arguments = {"skip", "drop"};
+						parameter_unknown(process.getName(), argv[currentOptionIndex], arguments);
+						return EXIT_FAILURE;
+					}
+					break;
+				}
+				case Args::HLS_DURATION_SECONDS: {
+					char *end;
+					long value=strtol(optarg, &end, 10);
+					if( (*end != 0) || (value < 1) || (value > 60) ) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number of seconds from 1 to 60.");
+						return EXIT_FAILURE;
+					}
+					hlsDuration=value;
+					break;
+				}
+				case Args::HLS_SEGMENT_COUNT: {
+					char *end;
+					long value=strtol(optarg, &end, 10);
+					if( (*end != 0) || (value < 2) || (value > 1000) ) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number from 2 to 1000.");
+						return EXIT_FAILURE;
+					}
+					hlsSegments=value;
+					break;
+				}
+				case Args::HLS_MIRROR: {
+					hlsMirror=optarg;
+					break;
+				}
+				case Args::INDEX: {
+					index=true;
+					break;
+				}
+				case Args::MULTICAST_INTERFACE: {
+					multicastInterface=optarg;
+					multicastSet=true;
+					break;
+				}
+				case Args::MULTICAST_TTL: {
+					char *end;
+					long value=strtol(optarg, &end, 10);
+					if( (*end != 0) || (value < 0) || (value > 255) ) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number from 0 to 255.");
+						return EXIT_FAILURE;
+					}
+					multicastTtl=value;
+					multicastSet=true;
+					break;
+				}
+				case Args::NO_MULTICAST_LOOP: {
+					multicastLoop=false;
+					multicastSet=true;
+					break;
+				}
+				case Args::USB_TRANSFERS: {
+					char *end;
+					unsigned long value=strtoul(optarg, &end, 10);
+					if(( *end != 0 ) || ( optarg[0] == '-' )) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a positive integer or 0.");
+						return EXIT_FAILURE;
+					}
+					deviceSettings.setIngestTransfers( value );
+					break;
+				}
+				case Args::ADAPTIVE_USB: {
+					deviceSettings.setAdaptiveTransfers(true);
+					break;
+				}
+				case Args::RING_BUFFERS: {
+					char *end;
+					unsigned long value=strtoul(optarg, &end, 10);
+					if(( *end != 0 ) || ( optarg[0] == '-' ) || ( value == 0 )) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a positive integer.");
+						return EXIT_FAILURE;
+					}
+					ringSize=value;
+					break;
+				}
+				case Args::LOCK_MEMORY: {
+					lockMemory=true;
+					break;
+				}
+				case Args::NO_REGISTER_CACHE: {
+					deviceSettings.setRegisterCache(false);
+					break;
+				}
+				case Args::FAST_INIT: {
+					deviceSettings.setFastInit(true);
+					break;
+				}
+				case Args::INIT_STATS: {
+					deviceSettings.setInitStats(true);
+					break;
+				}
+				case Args::MONITOR_INPUT: {
+					deviceSettings.setMonitorInput(true);
+					break;
+				}
+				case Args::RECORD: {
+					deviceSettings.setRecordPath(optarg);
+					break;
+				}
+				case Args::REPLAY: {
+					deviceSettings.setReplayPath(optarg);
+					break;
+				}
+				case Args::REPLAY_FAST: {
+					deviceSettings.setReplayTiming(false);
+					break;
+				}
+				case Args::DAEMON: {
+					daemon=true;
+					break;
+				}
+				case Args::RESUME: {
+					deviceSettings.setResumePath(optarg);
+					break;
+				}
+				case Args::CONTROL: {
+					controlPath = optarg;
+					break;
+				}
+				case Args::DVR: {
+					char *end;
+					long value=strtol(optarg, &end, 10);
+					if( (*end != 0) || (value < 1) || (value > 65536) ) {
+						parameter_error(process.getName(), argv[currentOptionIndex], "Must be a number of MiB from 1 to 65536.");
+						return EXIT_FAILURE;
+					}
+					dvrSize=value;
+					break;
+				}
+				case Args::DVR_FILE: {
+					dvrFile = optarg;
+					break;
+				}
 				case Args::HELP: {
 					help(process.getName(), false);
 					return EXIT_SUCCESS;
@@ -681,9 +1003,18 @@ int main(int argc, char *argv[]) {
 			return EXIT_FAILURE;
 		}
 	}
+	if (paceDelay && (format != Format::Udp) && (format != Format::Rtp)) {
+		std::cerr << "-pace only works with `udp` and `rtp` output formats." << std::endl;
+		return EXIT_FAILURE;
+	}
+	if (daemon && (format != Format::FIFO)) {
+		std::cerr << "-daemon only works with `fifo` output format." << std::endl;
+		return EXIT_FAILURE;
+	}
 
 	//Deal with merging output, ip, and port
-	if (format == Format::Socket) {
+	if ((format == Format::Socket) || (format == Format::Udp) || (format == Format::Rtp) ||
+	    (format == Format::Tcp) || (format == Format::Http) || (format == Format::Hls)) {
 		std::string address;
 		std::string ipPort;
 
@@ -703,10 +1034,26 @@ int main(int argc, char *argv[]) {
 		}
 	}
 
+	if (multicastSet && !Utility::isMulticastAddress(ip)) {
+		std::cerr << "Multicast options need a multicast group as <destination>, `"
+			  << ip << "` isn't one." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (index && (format != Format::Disk)) {
+		std::cerr << "-index only works with `disk` output." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (!dvrFile.empty() && !dvrSize) {
+		std::cerr << "-dvr-file needs -dvr to give its size." << std::endl;
+		return EXIT_FAILURE;
+	}
+
 	//Try block wraps GCHD creation so if exception gets thrown,
 	//stack unwinding will destruct object, calling uninit.
 	try {
-		GCHD gchd(&process, inputSettings, transcoderSettings);
+		GCHD gchd(&process, inputSettings, transcoderSettings, deviceSettings);
 
 		if(gchd.checkDevice()) {
 			return EXIT_FAILURE;
@@ -714,28 +1061,97 @@ int main(int argc, char *argv[]) {
 
 		// helper class for streaming audio and video from device
 		Streamer streamer(&gchd, &process);
+		streamer.setRingSize(ringSize);
+		streamer.setLockMemory(lockMemory);
+		streamer.setStripNull(stripNull);
+		streamer.socket.setPacing(paceDelay);
+		streamer.socket.setMulticastInterface(multicastInterface);
+		streamer.socket.setMulticastTtl(multicastTtl);
+		streamer.socket.setMulticastLoop(multicastLoop);
 
 		// enable output
 		int ret;
 
 		switch (format) {
-			case Format::Disk: ret = streamer.disk.enable(output); break;
-			case Format::FIFO: ret = streamer.fifo.enable(output); break;
+			case Format::Disk:
+				streamer.disk.setIndex(index);
+				ret = streamer.disk.enable(output);
+				break;
+			case Format::FIFO: ret = daemon ? streamer.fifo.create(output) : streamer.fifo.enable(output); break;
 			case Format::Socket: ret = streamer.socket.enable(ip, port); break;
+			case Format::Udp:
+				streamer.socket.setPacking(SocketPacking::Udp);
+				ret = streamer.socket.enable(ip, port);
+				break;
+			case Format::Rtp:
+				streamer.socket.setPacking(SocketPacking::Rtp);
+				ret = streamer.socket.enable(ip, port);
+				break;
+			case Format::Tcp:
+				streamer.server.setPolicy(slowClients);
+				ret = streamer.server.enable(ip, port);
+				break;
+			case Format::Http:
+				streamer.server.setPolicy(slowClients);
+				streamer.server.setProtocol(ServerProtocol::Http);
+				ret = streamer.server.enable(ip, port);
+				break;
+			case Format::Hls:
+				streamer.hls.setDuration(hlsDuration);
+				streamer.hls.setSegments(hlsSegments);
+				ret = streamer.hls.enable(hlsMirror);
+				if (!ret) {
+					streamer.server.setPolicy(slowClients);
+					streamer.server.setProtocol(ServerProtocol::Http);
+					streamer.server.setHls(&streamer.hls);
+					ret = streamer.server.enable(ip, port);
+				}
+				break;
 		}
 		if (ret) {
 			return EXIT_FAILURE;
 		}
 
-		//Likely aborted during waiting for user to open fifo.
-		if( process.isActive() ) {
+		if (dvrSize && streamer.dvr.enable(static_cast<uint64_t>(dvrSize) << 20, dvrFile)) {
+			return EXIT_FAILURE;
+		}
+
+		Control control(&gchd, &streamer);
+		if (!controlPath.empty() && control.enable(controlPath)) {
+			return EXIT_FAILURE;
+		}
+
+		if (daemon) {
+			//Device gets initialized once, then only the encoder is
+			//started and stopped for each reader of the fifo.
 			if(gchd.init()) {
 				return EXIT_FAILURE;
 			}
-		}
+			gchd.standby();
+			streamer.setEndOnDisconnect(true);
 
-		// immediately start receive loop after device init
-		streamer.loop();
+			while( process.isActive() ) {
+				if( streamer.fifo.connect() ) {
+					break; //Aborted during wait, or fifo is broken.
+				}
+				gchd.resume();
+				streamer.loop();
+				streamer.fifo.disconnect();
+				if( process.isActive() ) {
+					gchd.standby();
+				}
+			}
+		} else {
+			//Likely aborted during waiting for user to open fifo.
+			if( process.isActive() ) {
+				if(gchd.init()) {
+					return EXIT_FAILURE;
+				}
+			}
+
+			// immediately start receive loop after device init
+			streamer.loop();
+		}
 	} catch ( setting_error &error ) {
 		std::cerr << std::endl << error.what() << std::endl;
 		return EXIT_FAILURE;
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef RING_CLASS_H
+#define RING_CLASS_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//Lock-free ring for exactly one producer thread and one consumer thread.
+//
+//Items are swapped in and out rather than copied, so with containers
+//like std::vector the storage just circulates between producer, ring
+//and consumer, and nothing gets allocated once every slot has been used.
+template<typename T>
+class RingBuffer {
+	public:
+		RingBuffer(size_t capacity) : slots_(capacity + 1) {
+			head_ = 0;
+			tail_ = 0;
+			highWaterMark_ = 0;
+		}
+
+		//Producer side. Returns false if the ring is full, item is
+		//left untouched in that case.
+		bool push(T &item) {
+			size_t tail = tail_.load(std::memory_order_relaxed);
+			size_t next = advance(tail);
+
+			if (next == head_.load(std::memory_order_acquire)) {
+				return false;
+			}
+			std::swap(slots_[tail], item);
+			tail_.store(next, std::memory_order_release);
+
+			size_t used = size();
+			if (used > highWaterMark_.load(std::memory_order_relaxed)) {
+				highWaterMark_.store(used, std::memory_order_relaxed);
+			}
+			return true;
+		}
+
+		//Consumer side. Returns false if the ring is empty.
+		bool pop(T &item) {
+			size_t head = head_.load(std::memory_order_relaxed);
+
+			if (head == tail_.load(std::memory_order_acquire)) {
+				return false;
+			}
+			std::swap(item, slots_[head]);
+			head_.store(advance(head), std::memory_order_release);
+			return true;
+		}
+
+		bool empty() {
+			return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+		}
+
+		//Only exact when called from either the producer or consumer.
+		size_t size() {
+			size_t head = head_.load(std::memory_order_acquire);
+			size_t tail = tail_.load(std::memory_order_acquire);
+			return (tail + slots_.size() - head) % slots_.size();
+		}
+
+		size_t capacity() {
+			return slots_.size() - 1;
+		}
+
+		size_t getHighWaterMark() {
+			return highWaterMark_.load(std::memory_order_relaxed);
+		}
+
+	private:
+		size_t advance(size_t index) {
+			return (index + 1) % slots_.size();
+		}
+
+		std::vector<T> slots_;
+
+		//Producer and consumer each own one of these, pad them onto
+		//separate cache lines. (alignas would need C++17 aligned new.)
+		std::atomic<size_t> head_;
+		char headPadding_[64 - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> tail_;
+		char tailPadding_[64 - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> highWaterMark_;
+};
+
+#endif
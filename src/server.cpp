@@ -0,0 +1,544 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <netdb.h>
+#include <unistd.h>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <server.hpp>
+#include <ts.hpp>
+
+#define SERVER_EVENTS	64 // epoll events taken at once.
+
+int Server::enable(std::string ip, std::string port) {
+	struct addrinfo hints = {};
+	struct addrinfo *result, *entry;
+
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+
+	auto ret = getaddrinfo(ip.empty() ? nullptr : ip.c_str(), port.c_str(), &hints, &result);
+	std::cerr << "SERVER: Listening on ";
+	if (!ip.empty()) {
+		std::cerr << "[" << ip << "]";
+	}
+	std::cerr << ":" << port << std::endl;
+
+	if (ret) {
+		std::cerr << "Server error: " << gai_strerror(ret) << std::endl;
+		return 1;
+	}
+
+	for (entry = result; entry != nullptr; entry = entry->ai_next) {
+		listenFd_ = socket(entry->ai_family, entry->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+				   entry->ai_protocol);
+		if (listenFd_ < 0) {
+			continue;
+		}
+
+		int reuse = 1;
+		setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		if (!bind(listenFd_, entry->ai_addr, entry->ai_addrlen) && !listen(listenFd_, SERVER_BACKLOG)) {
+			break;
+		}
+
+		close(listenFd_);
+		listenFd_ = -1;
+	}
+	freeaddrinfo(result);
+
+	if (listenFd_ < 0) {
+		std::cerr << "Server error: " << strerror(errno) << "." << std::endl;
+		return 1;
+	}
+
+	epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+	wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ((epollFd_ < 0) || (wakeFd_ < 0)) {
+		std::cerr << "Server error: " << strerror(errno) << "." << std::endl;
+		disable();
+		return 1;
+	}
+
+	struct epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = listenFd_;
+	epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd_, &event);
+	event.data.fd = wakeFd_;
+	epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+
+	running_ = true;
+	thread_ = std::thread(&Server::serve, this);
+	return 0;
+}
+
+void Server::disable() {
+	if (thread_.joinable()) {
+		running_ = false;
+		uint64_t wake = 1;
+		write(wakeFd_, &wake, sizeof(wake));
+		thread_.join();
+		std::cerr << "Server: " << connections_ << " connections, " << bytesSent_
+			  << " bytes sent." << std::endl;
+	}
+	for (auto &client : clients_) {
+		close(client.first);
+	}
+	clients_.clear();
+	clientCount_ = 0;
+
+	for (int *fd : {&listenFd_, &epollFd_, &wakeFd_}) {
+		if (*fd != -1) {
+			close(*fd);
+			*fd = -1;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	history_.clear();
+}
+
+void Server::output(const Buffer &buffer) {
+	if (listenFd_ == -1) {
+		return;
+	}
+
+	size_t keyframe = SIZE_MAX;
+	for (size_t at = 0; at + TS_PACKET_SIZE <= buffer.size(); at += TS_PACKET_SIZE) {
+		const unsigned char *packet = buffer.data() + at;
+		if ((Ts::getPid(packet) == TS_VIDEO_PID) && Ts::isRandomAccess(packet)) {
+			keyframe = at;
+			break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		history_.push_back(Entry{nextSequence_++, buffer, keyframe});
+		if (history_.size() > SERVER_HISTORY) {
+			history_.pop_front();
+		}
+	}
+
+	// never blocks, the count just goes up if the server is busy
+	uint64_t wake = 1;
+	write(wakeFd_, &wake, sizeof(wake));
+}
+
+void Server::setPolicy(ServerPolicy policy) {
+	policy_ = policy;
+}
+
+unsigned Server::getHeldBuffers() {
+	return (listenFd_ != -1) ? SERVER_HISTORY : 0;
+}
+
+void Server::setProtocol(ServerProtocol protocol) {
+	protocol_ = protocol;
+}
+
+void Server::setHls(Hls *hls) {
+	hls_ = hls;
+}
+
+unsigned Server::getClients() {
+	return clientCount_;
+}
+
+unsigned long Server::getConnections() {
+	return connections_;
+}
+
+uint64_t Server::getBytesSent() {
+	return bytesSent_;
+}
+
+void Server::serve() {
+	std::array<struct epoll_event, SERVER_EVENTS> events;
+
+	while (running_) {
+		int count = epoll_wait(epollFd_, events.data(), events.size(), -1);
+
+		for (int event = 0; event < count; event++) {
+			int fd = events[event].data.fd;
+			uint32_t flags = events[event].events;
+
+			if (fd == listenFd_) {
+				acceptClients();
+			} else if (fd == wakeFd_) {
+				uint64_t wakes;
+				read(wakeFd_, &wakes, sizeof(wakes));
+				auto now = std::chrono::steady_clock::now();
+				for (auto it = clients_.begin(); it != clients_.end();) {
+					Client &client = (it++)->second;
+					const char *reason = nullptr;
+					if (client.streaming) {
+						reason = client.blocked ? nullptr : feed(client);
+					} else if (!client.closing &&
+						   (now - client.connected > std::chrono::milliseconds(SERVER_REQUEST_TIMEOUT))) {
+						reason = "timed out";
+					}
+					if (reason) {
+						drop(client.fd, reason);
+					}
+				}
+			} else {
+				auto it = clients_.find(fd);
+				if (it == clients_.end()) {
+					continue;
+				}
+				if (flags & (EPOLLERR | EPOLLHUP)) {
+					drop(fd, "disconnected");
+					continue;
+				}
+				if (flags & (EPOLLIN | EPOLLRDHUP)) {
+					const char *reason = receive(it->second);
+					if (reason) {
+						drop(fd, reason);
+						continue;
+					}
+				}
+				if (flags & EPOLLOUT) {
+					it->second.blocked = false;
+					const char *reason = feed(it->second);
+					if (reason) {
+						drop(fd, reason);
+					}
+				}
+			}
+		}
+	}
+}
+
+void Server::acceptClients() {
+	while (true) {
+		struct sockaddr_storage address;
+		socklen_t length = sizeof(address);
+		int fd = accept4(listenFd_, reinterpret_cast<struct sockaddr *>(&address), &length,
+				 SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			return;
+		}
+
+		char host[NI_MAXHOST], service[NI_MAXSERV];
+		std::string name = "unknown";
+		if (!getnameinfo(reinterpret_cast<struct sockaddr *>(&address), length, host, sizeof(host),
+				 service, sizeof(service), NI_NUMERICHOST | NI_NUMERICSERV)) {
+			name = std::string(host) + ":" + service;
+		}
+
+		int noDelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+		Client client = {fd, name, 0, 0, std::string(), 0, nullptr, 0, std::string(), false, false,
+				 false, std::chrono::steady_clock::now(), 0, 0};
+
+		// edge triggered, EPOLLOUT only comes once the kernel has room again
+		struct epoll_event event = {};
+		event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		event.data.fd = fd;
+		if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event)) {
+			close(fd);
+			continue;
+		}
+		clients_[fd] = client;
+		clientCount_ = clients_.size();
+		connections_++;
+
+		// HTTP clients only count once they ask for the stream
+		if (protocol_ == ServerProtocol::Raw) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			clients_[fd].streaming = true;
+			seekKeyframe(clients_[fd]);
+			std::cerr << "Server: " << name << " connected, " << clients_.size() << " clients." << std::endl;
+		}
+	}
+}
+
+// Raw clients have nothing to say, this just notices when they hang up.
+// HTTP ones are answered once their request head is in, anything they
+// send after that is ignored.
+const char *Server::receive(Client &client) {
+	char data[SERVER_REQUEST];
+
+	// edge triggered, so read until there's nothing left
+	while (true) {
+		ssize_t got = recv(client.fd, data, sizeof(data), MSG_DONTWAIT);
+		if (got == 0) {
+			return "disconnected";
+		}
+		if (got < 0) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+				return nullptr;
+			}
+			return "disconnected";
+		}
+		if (client.streaming || client.closing) {
+			continue;
+		}
+
+		client.request.append(data, got);
+		size_t end = std::min(client.request.find("\r\n\r\n"), client.request.find("\n\n"));
+		if (end != std::string::npos) {
+			return answer(client, client.request.substr(0, end));
+		}
+		if (client.request.size() > SERVER_REQUEST) {
+			refuse(client, "431 Request Header Fields Too Large");
+			return feed(client);
+		}
+	}
+}
+
+// Every path gets the stream but the HLS ones, only the request line
+// matters.
+const char *Server::answer(Client &client, const std::string &head) {
+	std::istringstream line(head);
+	std::string method, target, version;
+	line >> method >> target >> version;
+	client.request.clear();
+
+	bool get = (method == "GET");
+	uint64_t sequence;
+	if (version.compare(0, 7, "HTTP/1.") != 0) {
+		refuse(client, "400 Bad Request");
+	} else if (!get && (method != "HEAD")) {
+		refuse(client, "405 Method Not Allowed");
+	} else if (hls_ && (target == "/" HLS_PLAYLIST)) {
+		std::string playlist = hls_->getPlaylist();
+		respond(client, "200 OK", "application/vnd.apple.mpegurl", playlist.size());
+		if (get) {
+			client.owed += playlist;
+		}
+		client.closing = true;
+	} else if (hls_ && parseSegment(target, sequence)) {
+		Hls::Data segment = hls_->getSegment(sequence);
+		if (!segment) {
+			refuse(client, "404 Not Found");
+		} else {
+			respond(client, "200 OK", "video/mp2t", segment->size());
+			if (get) {
+				client.body = segment;
+			}
+			client.closing = true;
+		}
+	} else {
+		respond(client, "200 OK", "video/mp2t", -1);
+		if (get) {
+			std::lock_guard<std::mutex> lock(mutex_);
+			client.streaming = true;
+			seekKeyframe(client);
+			std::cerr << "Server: " << client.name << " connected, " << clients_.size() << " clients." << std::endl;
+		} else {
+			client.closing = true;
+		}
+	}
+	return feed(client);
+}
+
+// Response head. Without a length, the stream goes on until either side
+// closes.
+void Server::respond(Client &client, const std::string &status, const char *type, long long length) {
+	client.owed = "HTTP/1.1 " + status + "\r\n"
+		      "Content-Type: " + type + "\r\n";
+	if (length >= 0) {
+		client.owed += "Content-Length: " + std::to_string(length) + "\r\n";
+	}
+	if (status.compare(0, 3, "405") == 0) {
+		client.owed += "Allow: GET, HEAD\r\n";
+	}
+	// players in a browser fetch from wherever their page came from
+	client.owed += "Cache-Control: no-cache\r\n"
+		       "Access-Control-Allow-Origin: *\r\n"
+		       "Connection: close\r\n\r\n";
+	client.owedSent = 0;
+}
+
+void Server::refuse(Client &client, const std::string &status) {
+	respond(client, status, "text/plain", status.size() + 2);
+	client.owed += status + "\r\n";
+	client.closing = true;
+}
+
+// /segment-<sequence>.ts
+bool Server::parseSegment(const std::string &target, uint64_t &sequence) {
+	static const std::string prefix = "/segment-";
+	if ((target.compare(0, prefix.size(), prefix) != 0) || !isdigit(target[prefix.size()])) {
+		return false;
+	}
+	char *end;
+	sequence = strtoull(target.c_str() + prefix.size(), &end, 10);
+	return std::string(end) == ".ts";
+}
+
+// Sends as much as the kernel takes. Buffer handles are copied out under
+// the lock, so the history can move on while we write.
+const char *Server::feed(Client &client) {
+	while (true) {
+		std::array<Buffer, SERVER_WRITE> pieces;
+		std::array<struct iovec, SERVER_WRITE + 2> parts;
+		std::array<Part, SERVER_WRITE + 2> kinds;
+		size_t count = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (client.streaming && !history_.empty() &&
+			    (client.sequence < history_.front().sequence) && !catchUp(client)) {
+				return "fell behind";
+			}
+			if (client.owedSent < client.owed.size()) {
+				kinds[count] = Part::Owed;
+				parts[count++] = {&client.owed[client.owedSent], client.owed.size() - client.owedSent};
+			}
+			if (client.body) {
+				kinds[count] = Part::Body;
+				parts[count++] = {const_cast<unsigned char *>(client.body->data()) + client.bodySent,
+						  client.body->size() - client.bodySent};
+			}
+			if (!client.streaming || history_.empty() || (client.sequence >= nextSequence_)) {
+				if (!count) {
+					return client.closing ? "answered" : nullptr; // all sent
+				}
+			} else {
+				size_t piece = 0;
+				for (size_t entry = client.sequence - history_.front().sequence;
+				     (entry < history_.size()) && (piece < SERVER_WRITE); entry++, piece++) {
+					pieces[piece] = history_[entry].buffer;
+					size_t offset = piece ? 0 : client.offset;
+					kinds[count] = Part::Stream;
+					parts[count++] = {pieces[piece].data() + offset, pieces[piece].size() - offset};
+				}
+			}
+		}
+
+		struct msghdr message = {};
+		message.msg_iov = parts.data();
+		message.msg_iovlen = count;
+		ssize_t sent = sendmsg(client.fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (sent < 0) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+				client.blocked = true;
+				return nullptr;
+			}
+			return "connection lost";
+		}
+		client.bytes += sent;
+		bytesSent_ += sent;
+
+		size_t left = sent;
+		for (size_t part = 0; part < count; part++) {
+			size_t length = parts[part].iov_len;
+			if (left < length) {
+				switch (kinds[part]) {
+					case Part::Owed: client.owedSent += left; break;
+					case Part::Body: client.bodySent += left; break;
+					case Part::Stream: client.offset += left; break;
+				}
+				client.blocked = true;
+				return nullptr;
+			}
+			left -= length;
+			switch (kinds[part]) {
+				case Part::Owed:
+					client.owed.clear();
+					client.owedSent = 0;
+					break;
+				case Part::Body:
+					client.body.reset();
+					client.bodySent = 0;
+					break;
+				case Part::Stream:
+					client.sequence++;
+					client.offset = 0;
+					break;
+			}
+		}
+	}
+}
+
+bool Server::catchUp(Client &client) {
+	if (policy_ == ServerPolicy::Drop) {
+		return false;
+	}
+
+	// the client's stream has to stay whole packets
+	size_t partial = client.offset % TS_PACKET_SIZE;
+	if (partial) {
+		client.owed.append(TS_PACKET_SIZE - partial, '\xff');
+	}
+	client.skips++;
+	seekKeyframe(client);
+	return true;
+}
+
+// newest keyframe, or whatever comes next if there isn't one
+void Server::seekKeyframe(Client &client) {
+	client.sequence = nextSequence_;
+	client.offset = 0;
+	for (auto entry = history_.rbegin(); entry != history_.rend(); ++entry) {
+		if (entry->keyframe != SIZE_MAX) {
+			client.sequence = entry->sequence;
+			client.offset = entry->keyframe;
+			return;
+		}
+	}
+}
+
+void Server::drop(int fd, const char *reason) {
+	auto it = clients_.find(fd);
+	if (it == clients_.end()) {
+		return;
+	}
+
+	// playlist and segment requests come and go all the time
+	Client &client = it->second;
+	if (client.streaming) {
+		std::cerr << "Server: " << client.name << " " << reason << " after " << client.bytes << " bytes";
+		if (client.skips) {
+			std::cerr << ", skipped ahead " << client.skips << " times";
+		}
+		std::cerr << "." << std::endl;
+	}
+
+	epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+	close(fd);
+	clients_.erase(it);
+	clientCount_ = clients_.size();
+}
+
+Server::Server() {
+	listenFd_ = -1;
+	epollFd_ = -1;
+	wakeFd_ = -1;
+	running_ = false;
+	policy_ = ServerPolicy::Skip;
+	protocol_ = ServerProtocol::Raw;
+	hls_ = nullptr;
+	nextSequence_ = 0;
+	clientCount_ = 0;
+	connections_ = 0;
+	bytesSent_ = 0;
+}
+
+Server::~Server() {
+	disable();
+}
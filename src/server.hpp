@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef SERVER_CLASS_H
+#define SERVER_CLASS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <buffer.hpp>
+#include <hls.hpp>
+
+#define SERVER_HISTORY	64 // Buffers kept for clients that fall behind.
+#define SERVER_WRITE	16 // Most buffers sent to a client in one go.
+#define SERVER_BACKLOG	128 // Connections waiting to be accepted.
+#define SERVER_REQUEST	4096 // Longest HTTP request head.
+#define SERVER_REQUEST_TIMEOUT	5000 // How long a client has to send its request, in ms.
+
+//What to do with a client that falls further behind than SERVER_HISTORY.
+enum class ServerPolicy {
+	Drop, //Disconnect it.
+	Skip //Move it on to the newest keyframe.
+};
+
+//What clients have to say before they get the stream.
+enum class ServerProtocol {
+	Raw, //Nothing, the stream starts as soon as they connect.
+	Http //An HTTP/1.x GET, answered with a video/mp2t response that
+	     //lasts until the connection is closed, or with HLS.
+};
+
+//TCP listener serving the stream to any number of clients, from one
+//epoll thread.
+//
+//output() only adds a reference to the buffer to a shared history and
+//wakes the server thread, so no client can ever hold up the capture.
+//Every client has its own place in that history, and is sent from it
+//as fast as it takes the data, straight from the pooled buffers. New
+//clients start at the newest keyframe, so they can decode straight
+//away.
+class Server {
+	public:
+		int enable(std::string ip, std::string port);
+		void disable();
+		void output(const Buffer &buffer);
+		void setPolicy(ServerPolicy policy);
+		void setProtocol(ServerProtocol protocol);
+		//Serve hls's playlist and segments to HTTP clients as well.
+		void setHls(Hls *hls);
+		//Buffers output() may hold on to, their pool needs to be that
+		//much bigger.
+		unsigned getHeldBuffers();
+		//Safe from any thread.
+		unsigned getClients();
+		unsigned long getConnections(); //Accepted so far.
+		uint64_t getBytesSent();
+		Server();
+		~Server();
+
+	private:
+		struct Entry {
+			uint64_t sequence;
+			Buffer buffer;
+			size_t keyframe; //Offset of the first random access packet, SIZE_MAX if none.
+		};
+
+		enum class Part {Owed, Body, Stream};
+
+		struct Client {
+			int fd;
+			std::string name;
+			uint64_t sequence; //Next buffer to send,
+			size_t offset; //and how much of it has gone already.
+			std::string owed; //Sent ahead of the stream, a response head or
+			size_t owedSent; //filler finishing a packet cut short by a skip.
+			Hls::Data body; //HLS segment, sent after owed.
+			size_t bodySent;
+			std::string request; //HTTP request head so far.
+			bool streaming; //False until the HTTP request is in.
+			bool closing; //Hang up once owed has gone.
+			bool blocked; //Kernel buffer full, waiting for EPOLLOUT.
+			std::chrono::steady_clock::time_point connected;
+			uint64_t bytes;
+			unsigned long skips;
+		};
+
+		void serve(); //Server thread.
+		void acceptClients();
+		//These return why the client has to go, nullptr if it can stay.
+		const char *receive(Client &client);
+		const char *answer(Client &client, const std::string &head);
+		const char *feed(Client &client);
+		void respond(Client &client, const std::string &status, const char *type, long long length);
+		void refuse(Client &client, const std::string &status);
+		bool parseSegment(const std::string &target, uint64_t &sequence);
+		bool catchUp(Client &client); //Holding mutex_.
+		void seekKeyframe(Client &client); //Holding mutex_.
+		void drop(int fd, const char *reason);
+
+		int listenFd_;
+		int epollFd_;
+		int wakeFd_; //eventfd output() pokes.
+		std::thread thread_;
+		std::atomic<bool> running_;
+		ServerPolicy policy_;
+		ServerProtocol protocol_;
+		Hls *hls_;
+
+		std::mutex mutex_;
+		std::deque<Entry> history_;
+		uint64_t nextSequence_;
+
+		//Only used by the server thread.
+		std::unordered_map<int, Client> clients_;
+		std::atomic<unsigned> clientCount_;
+		std::atomic<unsigned long> connections_;
+		std::atomic<uint64_t> bytesSent_;
+};
+
+#endif
@@ -5,17 +5,31 @@
  * MIT License. For more information, see LICENSE file.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <random>
 
 #include <fcntl.h>
 #include <netdb.h>
 #include <unistd.h>
 
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 
 #include <socket.hpp>
 
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT	103 // linux/udp.h, Linux 4.18 and later
+#endif
+
 int Socket::enable(std::string ip, std::string port) {
 	struct addrinfo hints = {};
 	struct addrinfo *result, *entry;
@@ -55,6 +69,14 @@ int Socket::enable(std::string ip, std::string port) {
 			continue;
 		}
 
+		if (setMulticastOptions(entry)) {
+			close(fd_);
+			fd_ = -1;
+			freeaddrinfo(result);
+
+			return 1;
+		}
+
 		if (connect(fd_, entry->ai_addr, entry->ai_addrlen) != -1) {
 			// success
 			break;
@@ -84,26 +106,435 @@ int Socket::enable(std::string ip, std::string port) {
 		return 1;
 	}
 
+	if (isPacing()) {
+		paced_.reset(new RingBuffer<Buffer>(PACE_BUFFERS));
+		anchored_ = false;
+		pacerRunning_ = true;
+		pacerThread_ = std::thread(&Socket::pacer, this);
+	}
+
+	if ((packing_ != SocketPacking::Buffer) && (batching_ == SocketBatching::Gso)) {
+		int segment = SOCKET_PACKETS * TS_PACKET_SIZE;
+		if (packing_ == SocketPacking::Rtp) {
+			segment += RTP_HEADER_SIZE;
+		}
+		if (setsockopt(fd_, IPPROTO_UDP, UDP_SEGMENT, &segment, sizeof(segment))) {
+			batching_ = SocketBatching::Mmsg;
+		}
+	}
+
+	return 0;
+}
+
+int Socket::setMulticastOptions(const struct addrinfo *entry) {
+	unsigned index = 0;
+	if (!multicastInterface_.empty()) {
+		index = if_nametoindex(multicastInterface_.c_str());
+	}
+
+	int ret = 0;
+	if (entry->ai_family == AF_INET) {
+		auto group = reinterpret_cast<const struct sockaddr_in *>(entry->ai_addr);
+		if (!IN_MULTICAST(ntohl(group->sin_addr.s_addr))) {
+			return 0;
+		}
+
+		if (!multicastInterface_.empty()) {
+			struct ip_mreqn request = {};
+			request.imr_ifindex = index;
+			if (!index && (inet_pton(AF_INET, multicastInterface_.c_str(), &request.imr_address) != 1)) {
+				std::cerr << "Socket error: no interface " << multicastInterface_ << "." << std::endl;
+				return 1;
+			}
+			ret |= setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &request, sizeof(request));
+		}
+		if (multicastTtl_ >= 0) {
+			unsigned char ttl = multicastTtl_;
+			ret |= setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+		}
+		unsigned char loop = multicastLoop_;
+		ret |= setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+	} else if (entry->ai_family == AF_INET6) {
+		auto group = reinterpret_cast<const struct sockaddr_in6 *>(entry->ai_addr);
+		if (!IN6_IS_ADDR_MULTICAST(&group->sin6_addr)) {
+			return 0;
+		}
+
+		if (!multicastInterface_.empty()) {
+			if (!index) {
+				std::cerr << "Socket error: no interface " << multicastInterface_ << "." << std::endl;
+				return 1;
+			}
+			ret |= setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(index));
+		}
+		if (multicastTtl_ >= 0) {
+			int hops = multicastTtl_;
+			ret |= setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops, sizeof(hops));
+		}
+		unsigned loop = multicastLoop_;
+		ret |= setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop));
+	} else {
+		return 0;
+	}
+
+	if (ret) {
+		std::cerr << "Socket error: multicast options: " << strerror(errno) << "." << std::endl;
+		return 1;
+	}
+	std::cerr << "SOCKET: Sending to multicast group";
+	if (!multicastInterface_.empty()) {
+		std::cerr << " on " << multicastInterface_;
+	}
+	if (multicastTtl_ >= 0) {
+		std::cerr << ", TTL " << multicastTtl_;
+	}
+	std::cerr << (multicastLoop_ ? "" : ", no loopback") << std::endl;
 	return 0;
 }
 
 void Socket::disable() {
+	if (pacerThread_.joinable()) {
+		pacerRunning_ = false;
+		{
+			std::lock_guard<std::mutex> lock(pacerMutex_);
+			pacerReady_.notify_one();
+		}
+		pacerThread_.join();
+		paced_.reset();
+	}
 	if (fd_ != -1) {
 		close(fd_);
 		fd_ = -1;
 	}
+	pendingSize_ = 0;
 }
 
-void Socket::output(std::vector<unsigned char> *buffer) {
+void Socket::output(const Buffer &buffer) {
 	if (fd_ == -1) {
 		return;
 	}
 
-	write(fd_, buffer->data(), buffer->size());
+	if (paced_) {
+		// only a reference, pacer() gets the data in the same buffer
+		Buffer held = buffer;
+		if (!paced_->push(held)) {
+			std::lock_guard<std::mutex> lock(statsMutex_);
+			stats_.overruns++;
+			return;
+		}
+		if (pacerWaiting_) {
+			std::lock_guard<std::mutex> lock(pacerMutex_);
+			pacerReady_.notify_one();
+		}
+		return;
+	}
+	transmit(buffer);
+}
+
+void Socket::transmit(const Buffer &buffer) {
+	if (packing_ == SocketPacking::Buffer) {
+		write(fd_, buffer.data(), buffer.size());
+		return;
+	}
+
+	const unsigned char *data = buffer.data();
+	size_t size = buffer.size();
+	const size_t datagram = SOCKET_PACKETS * TS_PACKET_SIZE;
+
+	if (pendingSize_) {
+		size_t fill = std::min(datagram - pendingSize_, size);
+		memcpy(pending_.data() + pendingSize_, data, fill);
+		pendingSize_ += fill;
+		data += fill;
+		size -= fill;
+		if (pendingSize_ < datagram) {
+			return;
+		}
+		queue(pending_.data(), pendingSize_);
+	}
+
+	// straight out of the capture buffer
+	while (size >= datagram) {
+		queue(data, datagram);
+		data += datagram;
+		size -= datagram;
+	}
+	flush();
+
+	memcpy(pending_.data(), data, size);
+	pendingSize_ = size;
+}
+
+void Socket::setPacking(SocketPacking packing) {
+	packing_ = packing;
+}
+
+void Socket::setBatching(SocketBatching batching) {
+	batching_ = batching;
+}
+
+void Socket::setMulticastInterface(std::string interface) {
+	multicastInterface_ = interface;
+}
+
+void Socket::setMulticastTtl(int ttl) {
+	multicastTtl_ = ttl;
+}
+
+void Socket::setMulticastLoop(bool loop) {
+	multicastLoop_ = loop;
+}
+
+void Socket::setPacing(unsigned delay) {
+	paceDelay_ = delay;
+}
+
+bool Socket::isPacing() {
+	return paceDelay_ && (packing_ != SocketPacking::Buffer);
+}
+
+unsigned Socket::getHeldBuffers() {
+	return isPacing() ? PACE_BUFFERS : 0;
+}
+
+PacingStats Socket::getPacingStats() {
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	PacingStats stats = stats_;
+	stats.meanError = errors_ ? errorSum_ / errors_ : 0.0;
+	if (paced_) {
+		stats.queued = paced_->size();
+		stats.highWaterMark = paced_->getHighWaterMark();
+	}
+	return stats;
+}
+
+void Socket::pacer() {
+	Buffer buffer;
+
+	while (pacerRunning_) {
+		if (paced_->pop(buffer)) {
+			transmit(buffer);
+			buffer.reset();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(pacerMutex_);
+		pacerWaiting_ = true;
+		// re-check under lock, output() only notifies while holding it
+		if (paced_->empty() && pacerRunning_) {
+			pacerReady_.wait_for(lock, std::chrono::milliseconds(PACE_RESYNC));
+		}
+		pacerWaiting_ = false;
+	}
+}
+
+// Runs before the datagram is queued. If it is due later than those
+// queued already, they go out now and we sleep until it is.
+void Socket::pace(double pcr) {
+	if (pcr < 0.0) {
+		return; // no PCR yet, nothing to go by
+	}
+
+	auto now = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point due;
+	if (anchored_ && (pcr >= anchorPcr_)) {
+		due = anchorTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>((pcr - anchorPcr_) / 27000000));
+	}
+
+	// first datagram, PCR jumped or wrapped, or the clocks drifted apart
+	auto resync = std::chrono::milliseconds(PACE_RESYNC);
+	if (!anchored_ || (pcr < anchorPcr_) || (due < now - resync) ||
+	    (due > now + std::chrono::milliseconds(paceDelay_) + resync)) {
+		if (anchored_) {
+			std::lock_guard<std::mutex> lock(statsMutex_);
+			stats_.resyncs++;
+		}
+		anchored_ = true;
+		anchorPcr_ = pcr;
+		anchorTime_ = now + std::chrono::milliseconds(paceDelay_);
+		due = anchorTime_;
+	}
+
+	if (due > now + std::chrono::microseconds(PACE_SLACK)) {
+		flush();
+		std::this_thread::sleep_until(due);
+		now = std::chrono::steady_clock::now();
+	}
+
+	double error = std::abs(std::chrono::duration<double, std::micro>(now - due).count());
+	std::lock_guard<std::mutex> lock(statsMutex_);
+	errorSum_ += error;
+	errors_++;
+	stats_.maxError = std::max(stats_.maxError, error);
+}
+
+uint64_t Socket::getSyscalls() {
+	return syscalls_;
+}
+
+uint64_t Socket::getDatagrams() {
+	return datagrams_;
+}
+
+void Socket::queue(const unsigned char *data, size_t size) {
+	if (queued_ == SOCKET_BATCH) {
+		flush();
+	}
+
+	// back to back for sendGso()
+	double pcr = pcrAt(data, size);
+	if (paced_) {
+		pace(pcr);
+	}
+
+	unsigned parts = 0;
+	struct iovec *part = &parts_[partsQueued_];
+	if (packing_ == SocketPacking::Rtp) {
+		// RFC 2250 wants the time the first byte goes out, in 90 kHz
+		unsigned char *header = rtpHeaders_[queued_].data();
+		writeRtpHeader(header, static_cast<uint32_t>(static_cast<uint64_t>(std::max(pcr, 0.0)) / 300));
+		sequence_++;
+		part[parts++] = {header, RTP_HEADER_SIZE};
+	}
+	part[parts++] = {const_cast<unsigned char *>(data), size};
+
+	struct msghdr &message = messages_[queued_].msg_hdr;
+	message = {};
+	message.msg_iov = part;
+	message.msg_iovlen = parts;
+	partsQueued_ += parts;
+	queued_++;
+}
+
+void Socket::flush() {
+	if (!queued_) {
+		return;
+	}
+
+	switch (batching_) {
+		case SocketBatching::None: sendEach(0); break;
+		case SocketBatching::Mmsg: sendMmsg(0); break;
+		case SocketBatching::Gso:
+			if (!sendGso()) {
+				std::cerr << "Socket: UDP segmentation offload failed, using sendmmsg." << std::endl;
+				batching_ = SocketBatching::Mmsg;
+				sendMmsg(0);
+			}
+			break;
+	}
+	queued_ = 0;
+	partsQueued_ = 0;
+}
+
+// like the `socket` format, datagrams the kernel has no room for are
+// dropped rather than holding up the outputs
+void Socket::sendEach(unsigned first) {
+	for (unsigned message = first; message < queued_; message++) {
+		struct msghdr &header = messages_[message].msg_hdr;
+		syscalls_++;
+		if (writev(fd_, header.msg_iov, header.msg_iovlen) > 0) {
+			datagrams_++;
+		}
+	}
+}
+
+void Socket::sendMmsg(unsigned first) {
+	while (first < queued_) {
+		syscalls_++;
+		int sent = sendmmsg(fd_, &messages_[first], queued_ - first, 0);
+		if (sent <= 0) {
+			return;
+		}
+		datagrams_ += sent;
+		first += sent;
+	}
+}
+
+// The parts of all queued datagrams make up one send, cut into datagrams
+// by the kernel at the UDP_SEGMENT size set in enable(). Every datagram
+// queued is full size, so the cuts fall where they should.
+bool Socket::sendGso() {
+	struct msghdr message = {};
+	message.msg_iov = parts_.data();
+	message.msg_iovlen = partsQueued_;
+
+	syscalls_++;
+	if (sendmsg(fd_, &message, 0) >= 0) {
+		datagrams_ += queued_;
+		return true;
+	}
+	// full, not the kernel lacking GSO
+	return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS) || (errno == ECONNREFUSED);
+}
+
+// A PCR is the time the byte it sits in is due, in 27 MHz.
+double Socket::pcrAt(const unsigned char *data, size_t size) {
+	for (size_t at = 0; at < size; at += TS_PACKET_SIZE) {
+		uint64_t pcr;
+		if (!Ts::readPcr(data + at, pcr)) {
+			continue;
+		}
+		int64_t bytes = bytesSincePcr_ + static_cast<int64_t>(at);
+		if (pcrSeen_ && (bytes > 0) && (pcr > lastPcr_)) {
+			ticksPerByte_ = static_cast<double>(pcr - lastPcr_) / bytes;
+		}
+		lastPcr_ = pcr;
+		bytesSincePcr_ = -static_cast<int64_t>(at);
+		pcrSeen_ = true;
+	}
+
+	if (!pcrSeen_) {
+		return -1.0;
+	}
+	double pcr = lastPcr_ + bytesSincePcr_ * ticksPerByte_;
+	bytesSincePcr_ += size;
+	return pcr;
+}
+
+void Socket::writeRtpHeader(unsigned char *header, uint32_t timestamp) {
+	header[0] = 0x80; // version 2, no padding, extension or CSRCs
+	header[1] = RTP_TYPE_MP2T;
+	header[2] = sequence_ >> 8;
+	header[3] = sequence_;
+	header[4] = timestamp >> 24;
+	header[5] = timestamp >> 16;
+	header[6] = timestamp >> 8;
+	header[7] = timestamp;
+	header[8] = ssrc_ >> 24;
+	header[9] = ssrc_ >> 16;
+	header[10] = ssrc_ >> 8;
+	header[11] = ssrc_;
 }
 
 Socket::Socket() {
 	fd_ = -1;
+	multicastTtl_ = -1;
+	multicastLoop_ = true;
+	packing_ = SocketPacking::Buffer;
+	batching_ = SocketBatching::Gso;
+	pendingSize_ = 0;
+	queued_ = 0;
+	partsQueued_ = 0;
+	// receivers tell streams apart by SSRC, and expect sequence
+	// numbers to start anywhere
+	std::random_device random;
+	sequence_ = random();
+	ssrc_ = random();
+	pcrSeen_ = false;
+	lastPcr_ = 0;
+	bytesSincePcr_ = 0;
+	ticksPerByte_ = 0.0;
+	syscalls_ = 0;
+	datagrams_ = 0;
+	paceDelay_ = 0;
+	pacerRunning_ = false;
+	pacerWaiting_ = false;
+	anchored_ = false;
+	anchorPcr_ = 0.0;
+	stats_ = {};
+	errorSum_ = 0.0;
+	errors_ = 0;
 }
 
 Socket::~Socket() {
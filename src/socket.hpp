@@ -9,20 +9,150 @@
 #define SOCKET_CLASS_H
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
-#include <gchd.hpp>
+#include <netdb.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <buffer.hpp>
+#include <ring.hpp>
+#include <ts.hpp>
+
+#define SOCKET_PACKETS	7 // TS packets a datagram, the most that fit a 1500 byte MTU.
+#define RTP_HEADER_SIZE	12
+#define RTP_TYPE_MP2T	33 // RFC 3551 payload type for MPEG-2 TS.
+#define SOCKET_BATCH	48 // Most datagrams a send, GSO takes at most 64 KiB.
+#define PACE_BUFFERS	64 // Buffers held back for pacing, IE the jitter buffer.
+#define PACE_SLACK	100 // Datagrams due within this many us go out together, about what sleeps overshoot by.
+#define PACE_RESYNC	500 // Pacing starts over once this many ms off, IE after a PCR jump.
+
+enum class SocketPacking {
+	Buffer, //Each buffer as one datagram, whatever its size.
+	Udp, //SOCKET_PACKETS whole TS packets a datagram.
+	Rtp //The same behind an RFC 2250 RTP header.
+};
+
+//How `udp` and `rtp` datagrams are handed to the kernel.
+enum class SocketBatching {
+	None, //A syscall each.
+	Mmsg, //Up to SOCKET_BATCH in one sendmmsg().
+	Gso //Up to SOCKET_BATCH in one sendmsg(), split up by the kernel (UDP_SEGMENT).
+};
+
+struct PacingStats {
+	double meanError; //How far off sends were from when PCR said, in us.
+	double maxError;
+	size_t queued; //Buffers waiting to be sent.
+	size_t highWaterMark;
+	unsigned long overruns; //Buffers dropped, the queue was full.
+	unsigned long resyncs;
+};
 
 class Socket {
 	public:
 		int enable(std::string ip, std::string port);
 		void disable();
-		void output(std::vector<unsigned char> *buffer);
+		void output(const Buffer &buffer);
+		void setPacking(SocketPacking packing);
+		//Before enable(). Gso (default) falls back to Mmsg where the
+		//kernel doesn't have it.
+		void setBatching(SocketBatching batching);
+		//Before enable(). Rather than as buffers come in, `udp` and
+		//`rtp` datagrams are sent at the rate the PCR gives, `delay`
+		//ms after the first one came in, from a thread of their own.
+		//0 (default) sends straight away.
+		void setPacing(unsigned delay);
+		//Before enable(), only used if the destination is a multicast
+		//group. Interface is a name or an IPV4 address, empty leaves
+		//it to the routing table. TTL -1 keeps the system default,
+		//which doesn't leave the local network.
+		void setMulticastInterface(std::string interface);
+		void setMulticastTtl(int ttl);
+		void setMulticastLoop(bool loop); //Deliver to listeners on this host too, default.
+		bool isPacing();
+		//Buffers output() may hold on to, their pool needs to be that
+		//much bigger.
+		unsigned getHeldBuffers();
+		uint64_t getSyscalls();
+		uint64_t getDatagrams(); //Handed to the kernel.
+		PacingStats getPacingStats(); //Safe from any thread.
 		Socket();
 		~Socket();
 
 	private:
+		int setMulticastOptions(const struct addrinfo *entry);
+		void transmit(const Buffer &buffer);
+		void pacer(); //Pacing thread.
+		void pace(double pcr); //Waits until a datagram starting at pcr is due.
+		void queue(const unsigned char *data, size_t size);
+		void flush(); //Sends everything queued.
+		void sendEach(unsigned first);
+		void sendMmsg(unsigned first);
+		bool sendGso();
+		double pcrAt(const unsigned char *data, size_t size); //Of the datagram's first byte, -1 if unknown.
+		void writeRtpHeader(unsigned char *header, uint32_t timestamp);
+
 		int fd_;
+		std::string multicastInterface_;
+		int multicastTtl_;
+		bool multicastLoop_;
+		SocketPacking packing_;
+		SocketBatching batching_;
+
+		//Packets short of a whole datagram, sent once the next buffer
+		//fills it up.
+		std::array<unsigned char, SOCKET_PACKETS * TS_PACKET_SIZE> pending_;
+		size_t pendingSize_;
+
+		//Datagrams queued by output(), pointing into the buffer, or
+		//pending_ for the first. Each is its RTP header, if any, and
+		//the packets.
+		std::array<std::array<unsigned char, RTP_HEADER_SIZE>, SOCKET_BATCH> rtpHeaders_;
+		std::array<struct iovec, SOCKET_BATCH * 2> parts_;
+		std::array<struct mmsghdr, SOCKET_BATCH> messages_;
+		unsigned queued_;
+		unsigned partsQueued_;
+
+		uint16_t sequence_;
+		uint32_t ssrc_;
+
+		//Datagrams are timed by the last PCR, moved on by the bytes
+		//sent since at the rate between the last two PCRs.
+		bool pcrSeen_;
+		uint64_t lastPcr_;
+		int64_t bytesSincePcr_; //From lastPcr_ to the next datagram.
+		double ticksPerByte_;
+
+		uint64_t syscalls_;
+		uint64_t datagrams_;
+
+		//output() hands buffers to pacer() through this.
+		unsigned paceDelay_;
+		std::unique_ptr<RingBuffer<Buffer>> paced_;
+		std::thread pacerThread_;
+		std::atomic<bool> pacerRunning_;
+		std::atomic<bool> pacerWaiting_;
+		std::mutex pacerMutex_;
+		std::condition_variable pacerReady_;
+
+		//Only used by pacer(). anchorPcr_ is due at anchorTime_.
+		bool anchored_;
+		double anchorPcr_;
+		std::chrono::steady_clock::time_point anchorTime_;
+
+		std::mutex statsMutex_;
+		PacingStats stats_;
+		double errorSum_;
+		uint64_t errors_;
 };
 
 #endif
@@ -6,27 +6,221 @@
  */
 
 #include <array>
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 #include <streamer.hpp>
 
 void Streamer::loop() {
-	std::vector<unsigned char> buffer=std::vector<unsigned char>(DATA_BUF);
+	if (!process_->isActive()) {
+		return;
+	}
 
-	if (process_->isActive()) {
-		std::cerr << "Streamer has been started." << std::endl;
+	// every buffer in the ring, plus whatever reader and outputs hold,
+	// plus those swapped into queued USB transfers, and those the
+	// socket holds back for pacing or the server for its clients
+	// kept across loops, so buffers are only allocated and locked once
+	if (!pool_) {
+		pool_ = std::make_shared<BufferPool>(ringSize_ + POOL_SLACK + gchd_->getQueuedTransfers() +
+						     socket.getHeldBuffers() + server.getHeldBuffers(),
+						     gchd_->getMaximumTransferSize());
+		if (lockMemory_ && !pool_->lock()) {
+			std::cerr << "Capture buffers locked in memory." << std::endl;
+		}
 	}
-	while (process_->isActive()) {
-		gchd_->stream(&buffer);
-		if( buffer.size() != 0 ) {
-			disk.output(&buffer);
-			fifo.output(&buffer);
-			socket.output(&buffer);
+	ring_.reset(new RingBuffer<Buffer>(ringSize_));
+	buffers_ = 0;
+	bytes_ = 0;
+	overruns_ = 0;
+	stripped_ = 0;
+	readerRunning_ = true;
+	sessionDone_ = false;
+	readerError_ = nullptr;
+	// each session is a stream of its own
+	aligner_.reset();
+	splicer_.reset();
+	stripper_.reset();
+	restarts_ = gchd_->getRestarts();
+
+	std::thread reader(&Streamer::read, this);
+	std::cerr << "Streamer has been started." << std::endl;
+	auto start = std::chrono::steady_clock::now();
+
+	Buffer buffer;
+
+	// keep draining after the reader stops, outputs get everything read
+	while (true) {
+		if (ring_->pop(buffer)) {
+			buffers_++;
+			bytes_ += buffer.size();
+			disk.output(buffer);
+			fifo.output(buffer);
+			socket.output(buffer);
+			server.output(buffer);
+			hls.output(buffer);
+			dvr.output(buffer);
+			// don't leave a reference behind in the ring slot
+			buffer.reset();
+			if (endOnDisconnect_ && !fifo.isConnected()) {
+				sessionDone_ = true;
+			}
+		} else if (readerRunning_) {
+			wait();
+		} else if (ring_->empty()) {
+			break;
 		}
 	}
+	reader.join();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << "Streamer: " << buffers_ << " buffers, " << bytes_ << " bytes at "
+		  << (seconds > 0.0 ? bytes_ * 8 / seconds / 1000000 : 0.0) << " Mbit/s, ring high water mark "
+		  << ring_->getHighWaterMark() << "/" << ring_->capacity()
+		  << ", " << overruns_ << " overruns." << std::endl;
+	if (aligner_.getLostSync() || aligner_.getDiscarded()) {
+		std::cerr << "Streamer: lost TS sync " << aligner_.getLostSync() << " times, "
+			  << aligner_.getDiscarded() << " bytes thrown away." << std::endl;
+	}
+	if (socket.isPacing()) {
+		PacingStats pacing = socket.getPacingStats();
+		std::cerr << "Streamer: paced to within " << pacing.meanError << " us on average, "
+			  << pacing.maxError << " us at worst, queue high water mark "
+			  << pacing.highWaterMark << "/" << PACE_BUFFERS << ", " << pacing.overruns
+			  << " overruns, " << pacing.resyncs << " resyncs." << std::endl;
+	}
+	if (stripNull_) {
+		std::cerr << "Streamer: stripped " << stripped_ << " bytes of null packets, "
+			  << (seconds > 0.0 ? stripped_ / seconds / 1024 : 0.0) << " KiB/s saved." << std::endl;
+	}
+	if (splicer_.getSplices()) {
+		std::cerr << "Streamer: spliced " << splicer_.getSplices() << " encoder restarts, "
+			  << splicer_.getDropped() << " bytes left out." << std::endl;
+	}
+
+	if (readerError_) {
+		std::rethrow_exception(readerError_);
+	}
+}
+
+void Streamer::setRingSize(unsigned size) {
+	ringSize_ = size;
+}
+
+void Streamer::setLockMemory(bool lock) {
+	lockMemory_ = lock;
+}
+
+void Streamer::setStripNull(bool strip) {
+	stripNull_ = strip;
+}
+
+void Streamer::setEndOnDisconnect(bool end) {
+	endOnDisconnect_ = end;
+}
+
+unsigned long Streamer::getBuffers() {
+	return buffers_;
+}
+
+uint64_t Streamer::getBytes() {
+	return bytes_;
+}
+
+unsigned long Streamer::getOverruns() {
+	return overruns_;
+}
+
+uint64_t Streamer::getStripped() {
+	return stripped_;
+}
+
+void Streamer::read() {
+	Buffer buffer;
+
+	// only used when outputs hold on to every buffer in the pool, the
+	// device still needs to be read then
+	Buffer spare = pool_->acquire();
+
+	try {
+		while (process_->isActive() && !sessionDone_) {
+			if (!buffer.valid()) {
+				buffer = pool_->acquire();
+			}
+			if (!buffer.valid()) {
+				gchd_->stream(spare);
+				packetize(spare);
+				if (!spare.empty()) {
+					overruns_++;
+				}
+				continue;
+			}
+
+			gchd_->stream(buffer);
+			packetize(buffer);
+			if (buffer.empty()) {
+				continue;
+			}
+			if (!ring_->push(buffer)) {
+				// outputs fell behind, drop this one rather than stall USB
+				overruns_++;
+				continue;
+			}
+			if (consumerWaiting_) {
+				std::lock_guard<std::mutex> lock(mutex_);
+				dataReady_.notify_one();
+			}
+		}
+	} catch (...) {
+		readerError_ = std::current_exception();
+		process_->setActive(false);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	readerRunning_ = false;
+	dataReady_.notify_one();
+}
+
+void Streamer::packetize(Buffer &buffer) {
+	// stream() restarted the encoder, this is the start of the new stream
+	if (gchd_->getRestarts() != restarts_) {
+		restarts_ = gchd_->getRestarts();
+		aligner_.resync();
+		splicer_.splice();
+	}
+	// overruns go through here too, so what follows still lines up
+	aligner_.process(buffer);
+	splicer_.process(buffer);
+	if (stripNull_) {
+		// after the splicer, which has to see every counter
+		stripper_.process(buffer);
+		stripped_ = stripper_.getStripped();
+	}
+}
+
+void Streamer::wait() {
+	std::unique_lock<std::mutex> lock(mutex_);
+	consumerWaiting_ = true;
+	// re-check under lock, reader only notifies while holding it
+	if (ring_->empty() && readerRunning_) {
+		dataReady_.wait_for(lock, std::chrono::milliseconds(TIMEOUT));
+	}
+	consumerWaiting_ = false;
 }
 
 Streamer::Streamer(GCHD *gchd, Process *process) {
 	gchd_ = gchd;
 	process_ = process;
+	ringSize_ = RING_SIZE;
+	lockMemory_ = false;
+	stripNull_ = false;
+	readerRunning_ = false;
+	endOnDisconnect_ = false;
+	sessionDone_ = false;
+	consumerWaiting_ = false;
+	buffers_ = 0;
+	bytes_ = 0;
+	overruns_ = 0;
+	stripped_ = 0;
+	restarts_ = 0;
 }
@@ -8,23 +8,87 @@
 #ifndef STREAMER_CLASS_H
 #define STREAMER_CLASS_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <buffer.hpp>
 #include <disk.hpp>
+#include <dvr.hpp>
 #include <fifo.hpp>
 #include <gchd.hpp>
+#include <hls.hpp>
 #include <process.hpp>
+#include <ring.hpp>
+#include <server.hpp>
 #include <socket.hpp>
+#include <ts.hpp>
+
+#define RING_SIZE	256 // Buffers between USB reader and outputs, about 4 MiB.
+#define POOL_SLACK	3 // Buffers held by reader, its spare, and outputs.
 
 class Streamer {
 	public:
 		void loop();
+		void setRingSize(unsigned size);
+		void setLockMemory(bool lock);
+		//Leave null packets out of what goes to the outputs.
+		void setStripNull(bool strip);
+		//Have loop() return once the FIFO reader goes away, rather than
+		//streaming to nowhere.
+		void setEndOnDisconnect(bool end);
+		//Current session, safe from any thread.
+		unsigned long getBuffers();
+		uint64_t getBytes();
+		unsigned long getOverruns();
+		uint64_t getStripped();
 		Disk disk;
 		Fifo fifo;
 		Socket socket;
+		Server server;
+		Hls hls;
+		Dvr dvr;
 		Streamer(GCHD *gchd, Process *process);
 
 	private:
+		void read(); //USB reader thread.
+		void wait(); //Consumer waits for reader.
+		//Reader passes everything through aligner_, splicer_ and
+		//stripper_, so outputs only ever get whole packets.
+		void packetize(Buffer &buffer);
+
 		GCHD *gchd_;
 		Process *process_;
+
+		//USB reader fills this, loop() drains it to the outputs, so
+		//a slow output can never hold up the device.
+		unsigned ringSize_;
+		bool lockMemory_;
+		bool stripNull_;
+		std::shared_ptr<BufferPool> pool_;
+		std::unique_ptr<RingBuffer<Buffer>> ring_;
+		std::atomic<bool> readerRunning_;
+		bool endOnDisconnect_;
+		std::atomic<bool> sessionDone_; //Reader stops when set.
+		std::atomic<bool> consumerWaiting_;
+		std::mutex mutex_;
+		std::condition_variable dataReady_;
+		std::exception_ptr readerError_;
+
+		//Only used by the reader.
+		TsAligner aligner_;
+		TsSplicer splicer_;
+		TsNullStripper stripper_;
+		unsigned restarts_; //GCHD restarts splicer_ has been told about.
+
+		std::atomic<unsigned long> buffers_;
+		std::atomic<uint64_t> bytes_;
+		std::atomic<unsigned long> overruns_;
+		std::atomic<uint64_t> stripped_;
 };
 
 #endif
@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+//Looks up keyframes in the index `gchd -index` writes next to a
+//recording.
+//
+//   gchd-index <recording or index>
+//      Lists every keyframe: byte offset, time into the recording, PTS,
+//      DTS and PCR.
+//   gchd-index <recording or index> <time>
+//      Prints the byte offset of the last keyframe at or before <time>,
+//      [[hh:]mm:]ss[.fff] into the recording, or pts:<ticks> for a 90 kHz
+//      PTS as the index has it. IE
+//      tail -c +$(($(gchd-index rec.ts 1:30:00) + 1)) rec.ts | ffplay -
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include <index.hpp>
+
+// seconds, as [[hh:]mm:]ss[.fff]
+static bool parseTime(const std::string &text, double &seconds) {
+	seconds = 0;
+	size_t from = 0;
+	for (unsigned field = 0; field < 3; field++) {
+		size_t colon = text.find(':', from);
+		std::string part = text.substr(from, colon - from);
+		char *end;
+		double value = strtod(part.c_str(), &end);
+		if (part.empty() || *end || (value < 0)) {
+			return false;
+		}
+		seconds = seconds * 60 + value;
+		if (colon == std::string::npos) {
+			return true;
+		}
+		from = colon + 1;
+	}
+	return false;
+}
+
+static std::string formatTime(uint64_t pts) {
+	uint64_t milliseconds = pts / 90;
+	std::ostringstream text;
+	text << milliseconds / 3600000 << ":" << std::setfill('0') << std::setw(2)
+	     << milliseconds / 60000 % 60 << ":" << std::setw(2) << milliseconds / 1000 % 60
+	     << "." << std::setw(3) << milliseconds % 1000;
+	return text.str();
+}
+
+static std::string formatTimestamp(uint64_t timestamp) {
+	return (timestamp == INDEX_UNKNOWN) ? "-" : std::to_string(timestamp);
+}
+
+int main(int argc, char *argv[]) {
+	if ((argc < 2) || (argc > 3)) {
+		std::cerr << "Usage:" << std::endl
+			  << "   " << argv[0] << " <recording or index> [<time>]" << std::endl
+			  << "      Without <time>, lists every keyframe. With it, prints the byte" << std::endl
+			  << "      offset of the last keyframe at or before <time>, given as" << std::endl
+			  << "      [[hh:]mm:]ss[.fff] into the recording or pts:<ticks>." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// the recording's name will do
+	std::string path = argv[1];
+	if (!access((path + INDEX_SUFFIX).c_str(), R_OK)) {
+		path += INDEX_SUFFIX;
+	}
+
+	IndexReader index;
+	if (index.open(path)) {
+		return EXIT_FAILURE;
+	}
+	IndexEntry first;
+	if (!index.read(0, first)) {
+		std::cerr << path << " has no keyframes yet." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (argc == 2) {
+		std::cout << "offset time pts dts pcr" << std::endl;
+		for (size_t entry = 0; entry < index.size(); entry++) {
+			IndexEntry keyframe;
+			if (!index.read(entry, keyframe)) {
+				break;
+			}
+			std::cout << keyframe.offset << " " << formatTime(keyframe.pts - first.pts) << " "
+				  << keyframe.pts << " " << keyframe.dts << " "
+				  << formatTimestamp(keyframe.pcr) << std::endl;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	std::string time = argv[2];
+	uint64_t pts;
+	double seconds;
+	if (time.compare(0, 4, "pts:") == 0) {
+		char *end;
+		pts = strtoull(time.c_str() + 4, &end, 10);
+		if ((time.size() == 4) || *end) {
+			std::cerr << "Can't make sense of " << time << "." << std::endl;
+			return EXIT_FAILURE;
+		}
+	} else if (parseTime(time, seconds)) {
+		pts = first.pts + static_cast<uint64_t>(seconds * 90000);
+	} else {
+		std::cerr << "Can't make sense of " << time << ", use [[hh:]mm:]ss[.fff] or pts:<ticks>." << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	IndexEntry keyframe;
+	if (!index.find(pts, keyframe)) {
+		std::cerr << "Can't read " << path << "." << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::cerr << "Keyframe at " << formatTime(keyframe.pts - first.pts) << ", PTS " << keyframe.pts
+		  << "." << std::endl;
+	std::cout << keyframe.offset << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+//Pushes a made up transport stream through Socket to a receiver on
+//loopback, once per way of batching datagrams, and reports syscalls and
+//sender CPU time per Mbit sent.
+//
+//   gchd-socket-bench [udp|rtp] [<seconds per run>]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include <buffer.hpp>
+#include <socket.hpp>
+
+#define BENCH_PORT	57385
+#define BENCH_BUFFER	(87 * TS_PACKET_SIZE) // About what one USB transfer holds.
+
+static double cpuSeconds() {
+	struct rusage usage;
+	getrusage(RUSAGE_THREAD, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+	       (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+// packets on one PID with a PCR every 20, as if at 20 Mbit/s
+static void fill(Buffer &buffer, uint64_t &packet) {
+	for (size_t at = 0; at < buffer.size(); at += TS_PACKET_SIZE, packet++) {
+		unsigned char *data = buffer.data() + at;
+		memset(data, 0xff, TS_PACKET_SIZE);
+		data[0] = TS_SYNC_BYTE;
+		data[1] = 0x01;
+		data[2] = 0x00;
+		data[3] = 0x30 | (packet & 0x0f);
+		data[4] = TS_PACKET_SIZE - 5;
+		data[5] = 0x00;
+		if (!(packet % 20)) {
+			uint64_t base = packet * TS_PACKET_SIZE * 8 * 90000 / 20000000;
+			data[5] = 0x10;
+			data[6] = base >> 25;
+			data[7] = base >> 17;
+			data[8] = base >> 9;
+			data[9] = base >> 1;
+			data[10] = ((base & 0x01) << 7) | 0x7e;
+			data[11] = 0x00;
+		}
+	}
+}
+
+static void run(const char *name, SocketPacking packing, SocketBatching batching, double seconds) {
+	int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+	struct sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(BENCH_PORT);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	int size = 8 << 20;
+	setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	if (bind(receiver, reinterpret_cast<struct sockaddr *>(&address), sizeof(address))) {
+		std::cerr << "Can't bind port " << BENCH_PORT << ": " << strerror(errno) << std::endl;
+		exit(EXIT_FAILURE);
+	}
+
+	std::atomic<bool> running(true);
+	std::atomic<uint64_t> received(0);
+	std::thread drain([&]() {
+		struct timeval timeout = {0, 100000};
+		setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		unsigned char datagram[65536];
+		while (running) {
+			if (recv(receiver, datagram, sizeof(datagram), 0) > 0) {
+				received++;
+			}
+		}
+	});
+
+	Socket socket;
+	socket.setPacking(packing);
+	socket.setBatching(batching);
+	if (socket.enable("127.0.0.1", std::to_string(BENCH_PORT))) {
+		exit(EXIT_FAILURE);
+	}
+
+	auto pool = std::make_shared<BufferPool>(1, BENCH_BUFFER);
+	Buffer buffer = pool->acquire();
+	buffer.resize(BENCH_BUFFER);
+	uint64_t packet = 0;
+
+	double cpu = cpuSeconds();
+	auto start = std::chrono::steady_clock::now();
+	auto end = start + std::chrono::duration<double>(seconds);
+	while (std::chrono::steady_clock::now() < end) {
+		fill(buffer, packet);
+		socket.output(buffer);
+	}
+	cpu = cpuSeconds() - cpu;
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	running = false;
+	drain.join();
+	close(receiver);
+
+	double payload = SOCKET_PACKETS * TS_PACKET_SIZE;
+	double mbit = socket.getDatagrams() * payload * 8 / 1000000;
+	std::cout << name << ": " << mbit / elapsed << " Mbit/s, "
+		  << socket.getDatagrams() << " datagrams sent, " << received << " received, "
+		  << socket.getSyscalls() / mbit << " syscalls/Mbit, "
+		  << cpu * 1000000 / mbit << " us CPU/Mbit" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	SocketPacking packing = SocketPacking::Udp;
+	double seconds = 2.0;
+
+	for (int arg = 1; arg < argc; arg++) {
+		std::string value = argv[arg];
+		if (value == "udp") {
+			packing = SocketPacking::Udp;
+		} else if (value == "rtp") {
+			packing = SocketPacking::Rtp;
+		} else if (atof(argv[arg]) > 0.0) {
+			seconds = atof(argv[arg]);
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [udp|rtp] [<seconds per run>]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	run("writev", packing, SocketBatching::None, seconds);
+	run("sendmmsg", packing, SocketBatching::Mmsg, seconds);
+	run("gso", packing, SocketBatching::Gso, seconds);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <ts.hpp>
+
+// 33 bit base in 90 kHz, 6 reserved bits, 9 bit extension
+static uint64_t readPcr(const unsigned char *field) {
+	uint64_t base = (static_cast<uint64_t>(field[0]) << 25) | (field[1] << 17) |
+			(field[2] << 9) | (field[3] << 1) | (field[4] >> 7);
+	unsigned extension = ((field[4] & 0x01) << 8) | field[5];
+	return base * 300 + extension;
+}
+
+static void writePcr(unsigned char *field, uint64_t pcr) {
+	uint64_t base = pcr / 300;
+	unsigned extension = pcr % 300;
+	field[0] = base >> 25;
+	field[1] = base >> 17;
+	field[2] = base >> 9;
+	field[3] = base >> 1;
+	field[4] = ((base & 0x01) << 7) | 0x7e | (extension >> 8);
+	field[5] = extension;
+}
+
+// PTS or DTS, 33 bits in 90 kHz split up by marker bits
+static uint64_t readTimestamp(const unsigned char *field) {
+	return (static_cast<uint64_t>((field[0] >> 1) & 0x07) << 30) | (field[1] << 22) |
+	       ((field[2] >> 1) << 15) | (field[3] << 7) | (field[4] >> 1);
+}
+
+static void writeTimestamp(unsigned char *field, uint64_t timestamp) {
+	field[0] = (field[0] & 0xf0) | ((timestamp >> 29) & 0x0e) | 0x01;
+	field[1] = timestamp >> 22;
+	field[2] = ((timestamp >> 14) & 0xfe) | 0x01;
+	field[3] = timestamp >> 7;
+	field[4] = ((timestamp << 1) & 0xfe) | 0x01;
+}
+
+// PES streams without the optional header that holds PTS and DTS
+static bool hasPesHeader(unsigned char streamId) {
+	switch (streamId) {
+		case 0xbc: // program stream map
+		case 0xbe: // padding
+		case 0xbf: // private stream 2
+		case 0xf0: // ECM
+		case 0xf1: // EMM
+		case 0xf2: // DSMCC
+		case 0xf8: // H.222.1 type E
+		case 0xff: // program stream directory
+			return false;
+		default:
+			return true;
+	}
+}
+
+unsigned Ts::getPid(const unsigned char *packet) {
+	return ((packet[1] & 0x1f) << 8) | packet[2];
+}
+
+bool Ts::isPayloadStart(const unsigned char *packet) {
+	return packet[1] & 0x40;
+}
+
+bool Ts::readPcr(const unsigned char *packet, uint64_t &pcr) {
+	// adaptation field, at least 7 bytes long with the PCR flag set
+	if (!(packet[3] & 0x20) || (packet[4] < 7) || !(packet[5] & 0x10)) {
+		return false;
+	}
+	pcr = ::readPcr(packet + 6);
+	return true;
+}
+
+bool Ts::readPts(const unsigned char *packet, uint64_t &pts) {
+	uint64_t dts;
+	return readPts(packet, pts, dts);
+}
+
+bool Ts::readPts(const unsigned char *packet, uint64_t &pts, uint64_t &dts) {
+	unsigned control = (packet[3] >> 4) & 0x03;
+	size_t payload = (control & 0x02) ? 5 + packet[4] : 4;
+	if (!(packet[1] & 0x40) || !(control & 0x01) || (payload + 19 > TS_PACKET_SIZE)) {
+		return false;
+	}
+
+	const unsigned char *pes = packet + payload;
+	if ((pes[0] != 0x00) || (pes[1] != 0x00) || (pes[2] != 0x01) || !hasPesHeader(pes[3]) ||
+	    !(pes[7] & 0x80)) {
+		return false;
+	}
+	pts = readTimestamp(pes + 9);
+	dts = ((pes[7] & 0xc0) == 0xc0) ? readTimestamp(pes + 14) : pts;
+	return true;
+}
+
+bool Ts::isRandomAccess(const unsigned char *packet) {
+	unsigned control = (packet[3] >> 4) & 0x03;
+	size_t payload = 4;
+	if (control & 0x02) {
+		if ((packet[4] > 0) && (packet[5] & 0x40)) {
+			return true;
+		}
+		payload = 5 + packet[4];
+	}
+	if (!(packet[1] & 0x40) || !(control & 0x01) || (payload + 9 > TS_PACKET_SIZE)) {
+		return false;
+	}
+
+	// video PES, NAL units follow its header
+	const unsigned char *pes = packet + payload;
+	if ((pes[0] != 0x00) || (pes[1] != 0x00) || (pes[2] != 0x01) || ((pes[3] & 0xf0) != 0xe0)) {
+		return false;
+	}
+	for (size_t at = payload + 9 + pes[8]; at + 3 < TS_PACKET_SIZE; at++) {
+		if ((packet[at] == 0x00) && (packet[at + 1] == 0x00) && (packet[at + 2] == 0x01)) {
+			unsigned type = packet[at + 3] & 0x1f;
+			if ((type == 5) || (type == 7)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// offset of the first sync byte, or size if there is none
+static size_t findSync(const unsigned char *data, size_t size) {
+	size_t at = 0;
+#ifdef __SSE2__
+	// 16 bytes a compare, payload only rarely holds one
+	const __m128i sync = _mm_set1_epi8(TS_SYNC_BYTE);
+	for (; at + 16 <= size; at += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + at));
+		int found = _mm_movemask_epi8(_mm_cmpeq_epi8(block, sync));
+		if (found) {
+			return at + __builtin_ctz(found);
+		}
+	}
+#endif
+	for (; at < size; at++) {
+		if (data[at] == TS_SYNC_BYTE) {
+			return at;
+		}
+	}
+	return size;
+}
+
+TsAligner::TsAligner() {
+	reset();
+}
+
+void TsAligner::process(Buffer &buffer) {
+	if (carrySize_) {
+		if (buffer.headroom() < carrySize_) {
+			throw std::logic_error("No room in front of buffer for partial packet.");
+		}
+		buffer.setHeadroom(buffer.headroom() - carrySize_);
+		buffer.resize(buffer.size() + carrySize_);
+		memcpy(buffer.data(), carry_.data(), carrySize_);
+	}
+
+	unsigned char *data = buffer.data();
+	size_t size = buffer.size();
+
+	// packets only move if something in front of them was thrown away
+	size_t in = 0;
+	size_t out = 0;
+	while (in < size) {
+		if (!synced_) {
+			size_t sync = hunt(data, in, size);
+			discarded_ += sync - in;
+			in = sync;
+			if (!synced_) {
+				break; // keep what might be the start of a packet
+			}
+		}
+		if (size - in < TS_PACKET_SIZE) {
+			break;
+		}
+		if (data[in] != TS_SYNC_BYTE) {
+			synced_ = false;
+			lostSync_++;
+			continue;
+		}
+		if (out != in) {
+			memmove(data + out, data + in, TS_PACKET_SIZE);
+		}
+		in += TS_PACKET_SIZE;
+		out += TS_PACKET_SIZE;
+	}
+
+	carrySize_ = size - in;
+	memcpy(carry_.data(), data + in, carrySize_);
+	buffer.resize(out);
+}
+
+void TsAligner::resync() {
+	discarded_ += carrySize_;
+	carrySize_ = 0;
+	synced_ = false;
+}
+
+void TsAligner::reset() {
+	carrySize_ = 0;
+	synced_ = false;
+	lostSync_ = 0;
+	discarded_ = 0;
+}
+
+unsigned long TsAligner::getLostSync() {
+	return lostSync_;
+}
+
+uint64_t TsAligner::getDiscarded() {
+	return discarded_;
+}
+
+// Offset of the first sync byte followed by TS_RESYNC_PACKETS - 1 more
+// a packet apart, as far as the buffer goes. If the buffer ends before a
+// candidate can be checked at all, that candidate is returned with
+// synced_ still unset, there is at most a packet of it left.
+size_t TsAligner::hunt(const unsigned char *data, size_t from, size_t size) {
+	for (size_t at = from + findSync(data + from, size - from); at < size;
+	     at += 1 + findSync(data + at + 1, size - at - 1)) {
+		size_t next = at + TS_PACKET_SIZE;
+		if (next >= size) {
+			return at;
+		}
+
+		bool confirmed = true;
+		for (unsigned packet = 1; (packet < TS_RESYNC_PACKETS) && (next < size); packet++) {
+			if (data[next] != TS_SYNC_BYTE) {
+				confirmed = false;
+				break;
+			}
+			next += TS_PACKET_SIZE;
+		}
+		if (confirmed) {
+			synced_ = true;
+			return at;
+		}
+	}
+	return size;
+}
+
+TsNullStripper::TsNullStripper() {
+	reset();
+}
+
+void TsNullStripper::process(Buffer &buffer) {
+	unsigned char *data = buffer.data();
+	size_t whole = buffer.size() - buffer.size() % TS_PACKET_SIZE;
+
+	size_t out = 0;
+	for (size_t in = 0; in < whole; in += TS_PACKET_SIZE) {
+		unsigned pid = ((data[in + 1] & 0x1f) << 8) | data[in + 2];
+		if (pid == TS_NULL_PID) {
+			stripped_ += TS_PACKET_SIZE;
+			continue;
+		}
+		if (out != in) {
+			memcpy(data + out, data + in, TS_PACKET_SIZE);
+		}
+		out += TS_PACKET_SIZE;
+	}
+	buffer.resize(out);
+}
+
+void TsNullStripper::reset() {
+	stripped_ = 0;
+}
+
+uint64_t TsNullStripper::getStripped() {
+	return stripped_;
+}
+
+TsTables::TsTables() {
+	reset();
+}
+
+bool TsTables::isTable(const unsigned char *packet) {
+	unsigned pid = Ts::getPid(packet);
+	return Ts::isPayloadStart(packet) && ((pid == TS_PAT_PID) || (pid == TS_PMT_PID));
+}
+
+bool TsTables::update(const unsigned char *packet) {
+	if (!isTable(packet)) {
+		return false;
+	}
+	if (Ts::getPid(packet) == TS_PAT_PID) {
+		memcpy(pat_.data(), packet, TS_PACKET_SIZE);
+		patSeen_ = true;
+	} else {
+		memcpy(pmt_.data(), packet, TS_PACKET_SIZE);
+		pmtSeen_ = true;
+	}
+	return true;
+}
+
+void TsTables::append(std::vector<unsigned char> &data) const {
+	if (patSeen_) {
+		data.insert(data.end(), pat_.begin(), pat_.end());
+	}
+	if (pmtSeen_) {
+		data.insert(data.end(), pmt_.begin(), pmt_.end());
+	}
+}
+
+void TsTables::reset() {
+	patSeen_ = false;
+	pmtSeen_ = false;
+}
+
+TsSplicer::TsSplicer() {
+	reset();
+}
+
+void TsSplicer::process(Buffer &buffer) {
+	unsigned char *data = buffer.data();
+	size_t whole = buffer.size() - buffer.size() % TS_PACKET_SIZE;
+
+	now_ = std::chrono::steady_clock::now();
+	size_t out = 0;
+	for (size_t in = 0; in < whole; in += TS_PACKET_SIZE) {
+		if (!rewrite(data + in)) {
+			dropped_ += TS_PACKET_SIZE;
+			continue;
+		}
+		if (out != in) {
+			memmove(data + out, data + in, TS_PACKET_SIZE);
+		}
+		out += TS_PACKET_SIZE;
+	}
+	buffer.resize(out);
+}
+
+void TsSplicer::splice() {
+	for (auto &state : pids_) {
+		state.spliced = false;
+	}
+	splicing_ = true;
+	timeKnown_ = false;
+	splices_++;
+}
+
+void TsSplicer::reset() {
+	pids_.assign(TS_PID_COUNT, PidState{-1, 0, false});
+	splicing_ = false;
+	timeKnown_ = false;
+	pcrShift_ = 0;
+	pcrSeen_ = false;
+	lastPcr_ = 0;
+	splices_ = 0;
+	dropped_ = 0;
+}
+
+unsigned long TsSplicer::getSplices() {
+	return splices_;
+}
+
+uint64_t TsSplicer::getDropped() {
+	return dropped_;
+}
+
+bool TsSplicer::rewrite(unsigned char *packet) {
+	if (packet[0] != TS_SYNC_BYTE) {
+		return true; // not something we can make sense of, leave as is
+	}
+	unsigned pid = ((packet[1] & 0x1f) << 8) | packet[2];
+	if (pid == TS_NULL_PID) {
+		return true;
+	}
+
+	bool payloadStart = packet[1] & 0x40;
+	unsigned control = (packet[3] >> 4) & 0x03;
+	bool hasPayload = control & 0x01;
+	bool hasPcr = false;
+	size_t payload = 4;
+	if (control & 0x02) {
+		payload = 5 + packet[4];
+		hasPcr = (packet[4] >= 7) && (packet[5] & 0x10);
+	}
+	if (payload > TS_PACKET_SIZE) {
+		return true;
+	}
+
+	// nothing of the new stream can be placed on the old time base
+	// before its first PCR
+	if (splicing_ && !timeKnown_) {
+		if (!hasPcr) {
+			return false;
+		}
+		uint64_t pcr = readPcr(packet + 6);
+		uint64_t expected = pcr;
+		if (pcrSeen_) {
+			double gap = std::chrono::duration<double>(now_ - lastPcrTime_).count();
+			expected = (lastPcr_ + static_cast<uint64_t>(gap * 27000000)) % TS_PCR_RANGE;
+		}
+		pcrShift_ = (expected + TS_PCR_RANGE - pcr) % TS_PCR_RANGE;
+		timeKnown_ = true;
+	}
+
+	PidState &state = pids_[pid];
+	unsigned counter = packet[3] & 0x0f;
+	if (!state.spliced) {
+		// counter only goes up on packets with payload
+		if (state.counter >= 0) {
+			unsigned expected = (state.counter + (hasPayload ? 1 : 0)) & 0x0f;
+			state.counterShift = (expected - counter) & 0x0f;
+		}
+		state.spliced = true;
+	}
+	counter = (counter + state.counterShift) & 0x0f;
+	packet[3] = (packet[3] & 0xf0) | counter;
+	state.counter = counter;
+
+	if (hasPcr) {
+		uint64_t pcr = readPcr(packet + 6);
+		if (splicing_) {
+			pcr = (pcr + pcrShift_) % TS_PCR_RANGE;
+			writePcr(packet + 6, pcr);
+		}
+		lastPcr_ = pcr;
+		lastPcrTime_ = now_;
+		pcrSeen_ = true;
+	}
+
+	// PES header with PTS and DTS is 19 bytes, always in the first packet
+	if (splicing_ && payloadStart && hasPayload && (payload + 19 <= TS_PACKET_SIZE)) {
+		unsigned char *pes = packet + payload;
+		if ((pes[0] == 0x00) && (pes[1] == 0x00) && (pes[2] == 0x01) && hasPesHeader(pes[3])) {
+			unsigned flags = pes[7] >> 6;
+			if (flags & 0x02) {
+				rewriteTimestamp(pes + 9);
+			}
+			if (flags == 0x03) {
+				rewriteTimestamp(pes + 14);
+			}
+		}
+	}
+	return true;
+}
+
+void TsSplicer::rewriteTimestamp(unsigned char *field) {
+	uint64_t shift = pcrShift_ / 300;
+	writeTimestamp(field, (readTimestamp(field) + shift) & ((1ULL << 33) - 1));
+}
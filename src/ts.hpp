@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2014 - 2016 Tolga Cakir <tolga@cevel.net>
+ *
+ * This source file is part of Game Capture HD Linux driver and is distributed
+ * under the MIT License. For more information, see LICENSE file.
+ */
+
+#ifndef TS_CLASS_H
+#define TS_CLASS_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <buffer.hpp>
+
+#define TS_PACKET_SIZE	188
+#define TS_SYNC_BYTE	0x47
+#define TS_PID_COUNT	0x2000
+#define TS_NULL_PID	0x1fff
+#define TS_PAT_PID	0x0000
+#define TS_PMT_PID	0x0110 // As transcoder.cpp sets the device up.
+#define TS_VIDEO_PID	0x1011 // Likewise.
+#define TS_PCR_RANGE	(300ULL << 33) // PCR wraps here, in 27 MHz ticks.
+#define TS_PTS_RANGE	(1ULL << 33) // PTS and DTS wrap here, in 90 kHz ticks.
+#define TS_RESYNC_PACKETS	3 // Sync bytes in a row that must line up before we trust them again.
+
+namespace Ts {
+	unsigned getPid(const unsigned char *packet);
+
+	//Whether a PES, PSI section or similar starts in this packet.
+	bool isPayloadStart(const unsigned char *packet);
+
+	//PCR of a whole packet in 27 MHz ticks, if it carries one.
+	bool readPcr(const unsigned char *packet, uint64_t &pcr);
+
+	//PTS in 90 kHz ticks, if a PES that has one starts in this packet.
+	bool readPts(const unsigned char *packet, uint64_t &pts);
+	//And its DTS, the same as PTS if the PES has none.
+	bool readPts(const unsigned char *packet, uint64_t &pts, uint64_t &dts);
+
+	//Whether a decoder can start at this packet: random access
+	//indicator set, or the start of an H.264 PES that holds an SPS or
+	//IDR slice.
+	bool isRandomAccess(const unsigned char *packet);
+}
+
+//Cuts whatever USB hands us into whole packets, so outputs never need to
+//buffer up partial ones.
+//
+//Works in place on the capture buffer. Whatever is left of the last
+//packet is carried over into the headroom in front of the next buffer,
+//so only that partial packet is ever copied. Sync is checked
+//on every packet; if it is lost, IE data went missing, bytes are thrown
+//away until TS_RESYNC_PACKETS sync bytes in a row line up again.
+class TsAligner {
+	public:
+		TsAligner();
+
+		//Needs TS_PACKET_SIZE bytes of headroom for what is carried
+		//over. Buffer may come back empty.
+		void process(Buffer &buffer);
+
+		//Next buffer does not follow on from the last, drop what is
+		//carried over and look for sync again.
+		void resync();
+
+		void reset();
+
+		unsigned long getLostSync(); //Times sync was lost after having had it.
+		uint64_t getDiscarded(); //Bytes thrown away looking for sync.
+
+	private:
+		size_t hunt(const unsigned char *data, size_t from, size_t size);
+
+		std::array<unsigned char, TS_PACKET_SIZE> carry_;
+		size_t carrySize_;
+		bool synced_;
+
+		unsigned long lostSync_;
+		uint64_t discarded_;
+};
+
+//Drops the null packets the device pads the stream out to its fixed
+//multiplexer rate with. What is left is variable rate; PCRs still carry
+//the right time, so players are fine with it.
+//
+//Takes whole packets, as TsAligner hands them out.
+class TsNullStripper {
+	public:
+		TsNullStripper();
+
+		//Buffer may come back empty.
+		void process(Buffer &buffer);
+		void reset();
+
+		uint64_t getStripped(); //Bytes dropped.
+
+	private:
+		uint64_t stripped_;
+};
+
+//Keeps the latest PAT and PMT, so a stream cut out of the middle, IE an
+//HLS segment or a clip, can be started with them.
+//
+//Takes whole packets, as TsAligner hands them out. The device's tables
+//each fit a packet, so the packet is all there is to keep.
+class TsTables {
+	public:
+		TsTables();
+
+		static bool isTable(const unsigned char *packet); //Starts a PAT or PMT.
+		//Keeps packet if it is a table. Returns whether it was.
+		bool update(const unsigned char *packet);
+		//Appends the tables seen so far, PAT first.
+		void append(std::vector<unsigned char> &data) const;
+		void reset();
+
+	private:
+		std::array<unsigned char, TS_PACKET_SIZE> pat_;
+		std::array<unsigned char, TS_PACKET_SIZE> pmt_;
+		bool patSeen_;
+		bool pmtSeen_;
+};
+
+//Keeps the transport stream continuous when the device starts it over,
+//IE when the encoder is restarted after an input change.
+//
+//Takes whole packets, as TsAligner hands them out. After a splice the
+//new stream's continuity counters are shifted to follow on from the old
+//ones, and its PCR, PTS and DTS are moved onto the old time base, so
+//downstream never sees the restart.
+class TsSplicer {
+	public:
+		TsSplicer();
+
+		//Buffer may come back empty.
+		void process(Buffer &buffer);
+
+		//Next buffer starts a new stream.
+		void splice();
+
+		//Forget everything, for a stream that doesn't need to follow
+		//on from the last one.
+		void reset();
+
+		unsigned long getSplices();
+		uint64_t getDropped(); //Bytes left out to keep the stream consistent.
+
+	private:
+		struct PidState {
+			int8_t counter; //Last continuity counter sent, -1 if none.
+			uint8_t counterShift;
+			bool spliced; //counterShift has been worked out for this stream.
+		};
+
+		bool rewrite(unsigned char *packet); //False if packet must be dropped.
+		void rewriteTimestamp(unsigned char *field);
+
+		std::vector<PidState> pids_;
+
+		bool splicing_; //Timestamps need rewriting, set by first splice.
+		bool timeKnown_; //pcrShift_ is known for the current stream.
+		uint64_t pcrShift_;
+		bool pcrSeen_;
+		uint64_t lastPcr_; //As sent.
+		std::chrono::steady_clock::time_point lastPcrTime_;
+		std::chrono::steady_clock::time_point now_;
+
+		unsigned long splices_;
+		uint64_t dropped_;
+};
+
+#endif
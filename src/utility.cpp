@@ -7,10 +7,13 @@
 
 #include <cstdint>
 #include <climits>
+#include <cstdlib>
 #include <iterator>
 #include <cmath>
 #include <sstream>
 #include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
 #include "utility.hpp"
 
 namespace Utility
@@ -147,5 +150,43 @@ namespace Utility
 		return true;
 	}
 
+	bool isMulticastAddress( const std::string &address ) {
+		struct in_addr ipv4;
+		if( inet_pton(AF_INET, address.c_str(), &ipv4) == 1 ) {
+			return IN_MULTICAST(ntohl(ipv4.s_addr));
+		}
+
+		struct in6_addr ipv6;
+		std::string group=address.substr(0, address.find('%'));
+		if( inet_pton(AF_INET6, group.c_str(), &ipv6) == 1 ) {
+			return IN6_IS_ADDR_MULTICAST(&ipv6);
+		}
+		return false;
+	}
+
+	bool parseNumericResolution( unsigned long &x, unsigned long &y, const std::string input ) {
+		std::vector<std::string> splitValues=split(input,'x');
+		std::vector<unsigned long> numbers=std::vector<unsigned long>();
+
+		for( auto it = splitValues.begin(); it != splitValues.end(); ++it) {
+			char *endPtr;
+			std::string copy=*it;
+			copy=trim(copy); //Modifies copy
+
+			long value=strtoul( copy.c_str(), &endPtr, 10);
+
+			if( *endPtr != 0 ) {
+				return false;
+			}
+			numbers.push_back(value);
+		}
+		if( numbers.size() != 2 ) {
+			return false;
+		}
+		x=numbers[0];
+		y=numbers[1];
+		return true;
+	}
+
 }
 
@@ -80,6 +80,14 @@ namespace Utility
 	// returns false if clearly invalid, but otherwise validity is up to
 	// passing parts to getaddrinfo.
 	bool splitIPAddressAndPort( std::string &address, std::string &port, const std::string &passedInput);
+
+	//Whether an address as splitIPAddressAndPort() returns it is an
+	//IPV4 (224.0.0.0/4) or IPV6 (ff00::/8) multicast group. IPV6 may
+	//have a %<interface> scope, IE ff02::1%eth0.
+	bool isMulticastAddress( const std::string &address );
+
+	//<x>x<y>, IE 720x480. Returns false if not in that form.
+	bool parseNumericResolution( unsigned long &x, unsigned long &y, const std::string input );
 };
 
 //Some commands take a std::vector<unsigned char>